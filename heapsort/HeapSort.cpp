@@ -5,6 +5,8 @@
   Date: 14.12.2023 
 */
 
+// hybrid-quicksort/SortBenchmark.cpp includes this file inside namespace HEAP, after its own standard headers.
+// Every header included here must also be included there first, otherwise it is pulled into the namespace.
 #include <iostream>
 #include <vector>
 #include <string>
@@ -13,6 +15,17 @@
 #include <climits>
 #include <cmath>
 #include <chrono>
+#include <algorithm>
+
+/**
+ * @brief Statistics are compiled in only when HEAPSORT_STATS is defined (e.g. g++ -DHEAPSORT_STATS HeapSort.cpp).
+ * Otherwise HEAPSORT_STAT expands to nothing, so the heap functions do no extra work.
+ */
+#ifdef HEAPSORT_STATS
+#define HEAPSORT_STAT(statement) statement
+#else
+#define HEAPSORT_STAT(statement)
+#endif
 
 /**
  * @file Heapsort.cpp
@@ -30,6 +43,30 @@ struct Population {
 
 // int COMPARISON_COUNT = 0; // Global variable for comparison count
 
+#ifdef HEAPSORT_STATS
+/**
+ * @brief Counters collected by the heap functions built with HEAPSORT_STATS.
+ */
+struct HeapStats {
+  long long comparisons = 0; ///< Comparisons between two populations
+  long long swaps = 0;       ///< Swaps of two records
+  long long moves = 0;       ///< Records copied one at a time, a swap counts as 3
+  int depth = 0;             ///< Current recursion depth of max_heapify or dary_max_heapify
+  int maxDepth = 0;          ///< Deepest recursion depth of max_heapify or dary_max_heapify, 1 for a single call
+};
+
+thread_local HeapStats heap_stats; // heap statistics of the current thread, so parallel runs do not race on them
+
+/**
+ * @brief Writes the statistics of the run to a JSON file, one object per run.
+ * @param fileName Name of the JSON file.
+ * @param function Name of the function that ran.
+ * @param size Size of the vector at the end of the run.
+ * @param d Number of children of each node, 2 for the binary heap functions.
+ */
+void write_stats_json(const std::string fileName, const std::string function, size_t size, int d);
+#endif
+
 // Utility Functions
 
 /**
@@ -104,6 +141,13 @@ void build_max_heap(std::vector<Population> &vec, int size, const std::string fi
  */
 void heapsort(std::vector<Population> &vec, int size, const std::string fileName);
 
+/**
+ * @brief Sorts the vector using heapsort algorithm without writing it to a file, heapsort writes the result of this function.
+ * @param vec Vector to be sorted.
+ * @param size Size of the vector.
+ */
+void heapsort_in_place(std::vector<Population> &vec, int size);
+
 /**
  * @brief Inserts a new element to the heap.
  * @param vec Vector to be inserted.
@@ -219,12 +263,21 @@ void dary_increase_key(std::vector<Population> &vec, int i, int key, int d, cons
  */
 void dary_heapsort(std::vector<Population> &vec, int size, int d, const std::string fileName);
 
+/**
+ * @brief Sorts the vector using d-ary heapsort algorithm without writing it to a file, dary_heapsort writes the result of this function.
+ * @param vec Vector to be sorted.
+ * @param size Size of the vector.
+ * @param d Number of children of each node.
+ */
+void dary_heapsort_in_place(std::vector<Population> &vec, int size, int d);
+
 /**
  * @brief The main function that orchestrates the max heap process based on command line arguments.
  * @param argc Number of command line arguments.
  * @param argv Array of command line argument strings.
  * @return 0 if successful, 1 otherwise.
  */
+#ifndef HEAPSORT_NO_MAIN // defined by the tools that include this file for its heap functions
 int main(int argc, char **argv){
 
   std::string input_file_name; // mandatory parameters
@@ -502,13 +555,19 @@ int main(int argc, char **argv){
   }
 
   // std::cout << "Total comparison made by heapsort : " << COMPARISON_COUNT << std::endl; // print the total comparison count
+#ifdef HEAPSORT_STATS
+  write_stats_json("stats.json", function, population_data.size(), function.rfind("dary_", 0) == 0 ? d : 2); // next to the executable
+#endif
   return 0;
 }
+#endif
 
 // Utility Functions
 
 void quickSwap(std::vector<Population> &vec, int i1, int i2){ // swap two elements in a vector
   if(i1 == i2) {return;}
+  HEAPSORT_STAT(heap_stats.swaps++);
+  HEAPSORT_STAT(heap_stats.moves += 3);
   Population temp = vec[i1];
   vec[i1] = vec[i2];
   vec[i2] = temp;
@@ -569,6 +628,19 @@ void removeBOM(std::ifstream& file) { // remove BOM from the file
   }
 }
 
+#ifdef HEAPSORT_STATS
+void write_stats_json(const std::string fileName, const std::string function, size_t size, int d) {
+  std::ofstream file(fileName, std::ios::out | std::ios::trunc); // open file in trunc mode to overwrite, create if not exists
+  if(!file.is_open()) {
+    std::cerr << "File could not be opened at the path '" << fileName << "'!" << std::endl; // check whether the file is opened
+    return;
+  }
+  file << "{\"algorithm\": \"" << function << "\", \"d\": " << d << ", \"size\": " << size
+       << ", \"comparisons\": " << heap_stats.comparisons << ", \"swaps\": " << heap_stats.swaps
+       << ", \"moves\": " << heap_stats.moves << ", \"max_depth\": " << heap_stats.maxDepth << "}\n";
+}
+#endif
+
 // IO Functions
 
 void write_to_csv(const std::string fileName, const std::vector<Population> &vec, char mode, const std::string out = "") {
@@ -615,9 +687,12 @@ void read_from_csv(const std::string fileName, std::vector<Population> &vec) {
 // Heap Functions
 
 void max_heapify(std::vector<Population> &vec, int i, int size, const std::string fileName, bool writeToFile) {
+  HEAPSORT_STAT(heap_stats.depth++);
+  HEAPSORT_STAT(heap_stats.maxDepth = std::max(heap_stats.maxDepth, heap_stats.depth));
   int left = 2 * i + 1; // left child
   int right = 2 * i + 2; // right child
   int largest = i;
+  HEAPSORT_STAT(heap_stats.comparisons += (left < size) + (right < size)); // one per existing child
   if(left < size && vec[left].population > vec[largest].population) { // if left child is greater than the parent, largest is left child
     largest = left;
   }
@@ -631,6 +706,7 @@ void max_heapify(std::vector<Population> &vec, int i, int size, const std::strin
     max_heapify(vec, largest, size, fileName, writeToFile); // call max_heapify recursively
   }
   // COMPARISON_COUNT+=1; // 1 comparison is made in the if statement above
+  HEAPSORT_STAT(heap_stats.depth--);
   if(writeToFile) // if writeToFile is true, write the vector to file
     write_to_csv(fileName, vec, 'v');
 }
@@ -645,14 +721,18 @@ void build_max_heap(std::vector<Population> &vec, int size, const std::string fi
 }
 
 void heapsort(std::vector<Population> &vec, int size, const std::string fileName) {
-  build_max_heap(vec, size, fileName, false);                               // first build the max heap
+  heapsort_in_place(vec, size);
+  write_to_csv(fileName, vec, 'v'); // write the vector to file
+}
+
+void heapsort_in_place(std::vector<Population> &vec, int size) {
+  build_max_heap(vec, size, "", false);                                     // first build the max heap
   for(int i = size - 1; i >= 1; i--) {                                      // start from the last element and swap it with the first element, then call max_heapify recursively
      // max_heapify is called with i as the size of the heap, 
     quickSwap(vec, 0, i);                                                   // which is decreased by 1 at each iteration, so the last element is ignored at each iteration,   
-    max_heapify(vec, 0, i, fileName, false);                                // and as a result, the output array becomes in ascending order
+    max_heapify(vec, 0, i, "", false);                                      // and as a result, the output array becomes in ascending order
   }
   // COMPARISON_COUNT+=((size - 1) + 1); // total comparison made in for loop above
-  write_to_csv(fileName, vec, 'v'); // write the vector to file
 }
 
 void max_heap_insert(std::vector<Population> &vec, std::string city, int key, const std::string fileName) {
@@ -669,6 +749,7 @@ Population heap_extract_max(std::vector<Population> &vec, const std::string file
   Population max = vec[0]; // get the first element, it is the max element
   write_to_csv(fileName, std::vector<Population>(), 'o', max.city + "\n"); // passed vector is empty because we do not want to write the whole vector to file
   vec[0] = vec[vec.size() - 1]; // swap the first element, which is largest, with the last element of the heap
+  HEAPSORT_STAT(heap_stats.moves += 2); // the copy of the max and the last element
   vec.pop_back(); // pop the last element
   max_heapify(vec, 0, vec.size(), fileName, false); // call the max_heapify with index 0 to locate the new first element
   return max;
@@ -683,9 +764,11 @@ void heap_increase_key(std::vector<Population> &vec, int i, int key, const std::
   vec[i].population = key;                                                                // of the Population struct, as we hold the data as whole string, we need to change the population
                                                                                           // of the city in the string
   while(i > 0 && vec[(i-1)/2].population < vec[i].population) { // while the parent is smaller than the child, swap them and go up
+    HEAPSORT_STAT(heap_stats.comparisons++);
     quickSwap(vec, i, (i-1)/2);
     i = (i-1)/2;
   }
+  HEAPSORT_STAT(heap_stats.comparisons += (i > 0)); // the comparison that stopped the loop
 
   if (writeToFile) // if writeToFile is true, write the vector to file
     write_to_csv(fileName, vec, 'v');
@@ -699,6 +782,8 @@ Population heap_maximum(std::vector<Population> &vec, const std::string fileName
 // d-ary Heap Functions
 
 void dary_max_heapify(std::vector<Population> &vec, int i, int size, int d, const std::string fileName, bool writeToFile) {
+  HEAPSORT_STAT(heap_stats.depth++);
+  HEAPSORT_STAT(heap_stats.maxDepth = std::max(heap_stats.maxDepth, heap_stats.depth));
   std::vector<int> indices;
   for(int j = 1; j <= d; j++) {
     int idx = (d * i) + j;
@@ -709,12 +794,14 @@ void dary_max_heapify(std::vector<Population> &vec, int i, int size, int d, cons
     if(indices[j] != -1 && vec[indices[j]].population > vec[largest].population) { // if the child is not -1 and greater than the parent, largest is the current child
       largest = indices[j];
     }
+    HEAPSORT_STAT(heap_stats.comparisons += (indices[j] != -1));
   }
 
   if(largest != i) { // if largest is not the parent, swap the parent with the largest child and call dary_max_heapify recursively
   quickSwap(vec, i, largest);
   dary_max_heapify(vec, largest, size, d, fileName, writeToFile); // call dary_max_heapify recursively
   }
+  HEAPSORT_STAT(heap_stats.depth--);
   if(writeToFile) // if writeToFile is true, write the vector to file
     write_to_csv(fileName, vec, 'v');
 }
@@ -741,6 +828,7 @@ Population dary_extract_max(std::vector<Population> &vec, int d, const std::stri
   Population max = vec[0]; // get the first element, it is the max element
   write_to_csv(fileName, std::vector<Population>(), 'o', max.city + "\n"); // passed vector is empty because we do not want to write the whole vector to file
   vec[0] = vec[vec.size() - 1]; // swap the first element, which is the largest, with the last element of the heap
+  HEAPSORT_STAT(heap_stats.moves += 2); // the copy of the max and the last element
   vec.pop_back(); // pop the last element
   dary_max_heapify(vec, 0, vec.size(), d, fileName, false); // call the dary_max_heapify with index 0 to locate the new first element
   return max;
@@ -761,19 +849,25 @@ void dary_increase_key(std::vector<Population> &vec, int i, int key, int d, cons
   vec[i].population = key;                                                                // of the Population struct, as we hold the data as whole string, we need to change the population
                                                                                           // of the city in the string
   while(i > 0 && vec[(i-1)/d].population < vec[i].population) { // while the parent is smaller than the child, swap them and go up
+    HEAPSORT_STAT(heap_stats.comparisons++);
     quickSwap(vec, i, (i-1)/d);
     i = (i-1)/d;
   }
+  HEAPSORT_STAT(heap_stats.comparisons += (i > 0)); // the comparison that stopped the loop
 
   if (writeToFile) // if writeToFile is true, write the vector to file
     write_to_csv(fileName, vec, 'v'); 
 }
 
 void dary_heapsort(std::vector<Population> &vec, int size, int d, const std::string fileName) {
-  dary_build_max_heap(vec, size, d, fileName, false); // first build the max heap
-  for(int i = size - 1; i >= 1; i--) {                // start from the last element and swap it with the first element, then call dary_max_heapify recursively
-    quickSwap(vec, 0, i);                             // max_heapify is called with i as the size of the heap, which is decreased by 1 at each iteration, so the last element is ignored at each iteration
-    dary_max_heapify(vec, 0, i, d, fileName, false);  // and as a result, the output array becomes in ascending order
-  }
+  dary_heapsort_in_place(vec, size, d);
   write_to_csv(fileName, vec, 'v');
 }
+
+void dary_heapsort_in_place(std::vector<Population> &vec, int size, int d) {
+  dary_build_max_heap(vec, size, d, "", false); // first build the max heap
+  for(int i = size - 1; i >= 1; i--) {          // start from the last element and swap it with the first element, then call dary_max_heapify recursively
+    quickSwap(vec, 0, i);                       // max_heapify is called with i as the size of the heap, which is decreased by 1 at each iteration, so the last element is ignored at each iteration
+    dary_max_heapify(vec, 0, i, d, "", false);  // and as a result, the output array becomes in ascending order
+  }
+}
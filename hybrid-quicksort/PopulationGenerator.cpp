@@ -0,0 +1,223 @@
+/**
+  BLG335E - Analysis of Algorithms I - Project 1
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+/**
+ * @file PopulationGenerator.cpp
+ * @brief This file generates synthetic population datasets in the format of population1..4.csv.
+ *
+ * Every line is "city;population" with CRLF line endings after a UTF-8 BOM, as in the shipped files, so the output
+ * is read by QuickSort, HeapSort (both from their Data folder) and the tree programs without any change. City names
+ * are unique and made of letters only. The rows are generated in chunks, and the chunks of a batch are formatted
+ * in parallel and written in order. Every chunk has its own generator seeded from the seed and the chunk index, so
+ * the output depends on the seed only, not on the number of threads.
+ */
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+
+const long long MAX_POPULATION = 40000000; // a little above the largest city of the shipped files
+const long long CHUNK_ROWS = 1 << 18;      // rows formatted by one thread at a time
+
+/**
+ * @brief The distributions of the populations.
+ */
+enum Distribution {
+  UNIFORM,    ///< Uniform in [0, MAX_POPULATION]
+  ZIPF,       ///< MAX_POPULATION / k, where the rank k is Zipf distributed (s = 1), so a few large values repeat a lot
+  SORTED,     ///< Non-decreasing from 0 to MAX_POPULATION
+  REVERSE,    ///< Non-increasing from MAX_POPULATION to 0
+  ORGAN_PIPE, ///< Increasing over the first half and decreasing over the second half
+  FEW_UNIQUE  ///< 16 distinct values
+};
+
+/**
+ * @brief Parses the name of a distribution.
+ * @param name The name given on the command line.
+ * @param distribution The parsed distribution.
+ * @return True if the name is valid, otherwise false.
+ */
+bool parseDistribution(const std::string &name, Distribution &distribution) {
+  const std::string names[] = {"uniform", "zipf", "sorted", "reverse", "organpipe", "fewunique"};
+  for(int i = 0; i < 6; i++) {
+    if(name == names[i]) {
+      distribution = static_cast<Distribution>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+/**
+ * @brief Builds the cumulative weights of the Zipf ranks, searched with a random number to draw a rank.
+ * @param ranks Number of ranks.
+ * @return The cumulative weights, normalized so the last one is 1.
+ */
+std::vector<double> zipfCumulative(long long ranks) {
+  std::vector<double> cumulative(ranks);
+  double sum = 0;
+  for(long long k = 0; k < ranks; k++) {
+    sum += 1.0 / (k + 1);
+    cumulative[k] = sum;
+  }
+  for(double &weight : cumulative) {
+    weight /= sum;
+  }
+  return cumulative;
+}
+
+/**
+ * @brief Appends the city name of a row, its index in base 26 written with at least four letters.
+ * @param out The buffer to append to.
+ * @param row Index of the row.
+ */
+void appendCityName(std::string &out, long long row) {
+  char letters[16];
+  int length = 0;
+  do {
+    letters[length++] = static_cast<char>('a' + row % 26);
+    row /= 26;
+  } while(row > 0 || length < 4);
+  std::reverse(letters, letters + length);
+  letters[0] = static_cast<char>(letters[0] - 'a' + 'A');
+  out.append(letters, length);
+}
+
+/**
+ * @brief Formats the rows of one chunk.
+ * @param out The buffer to append the lines to.
+ * @param first Index of the first row of the chunk.
+ * @param count Number of rows in the chunk.
+ * @param rows Total number of rows of the dataset.
+ * @param distribution Distribution of the populations.
+ * @param seed Seed of the dataset.
+ * @param zipf Cumulative Zipf weights, only used by ZIPF.
+ */
+void formatChunk(std::string &out, long long first, long long count, long long rows, Distribution distribution,
+                 unsigned long long seed, const std::vector<double> &zipf) {
+  std::seed_seq sequence{seed, static_cast<unsigned long long>(first / CHUNK_ROWS)};
+  std::mt19937_64 generator(sequence);
+  std::uniform_int_distribution<long long> uniform(0, MAX_POPULATION);
+  std::uniform_int_distribution<int> fewUnique(1, 16);
+  std::uniform_real_distribution<double> unit(0.0, 1.0);
+  long long half = std::max<long long>(1, (rows + 1) / 2);
+
+  out.clear();
+  char digits[24];
+  for(long long row = first; row < first + count; row++) {
+    long long population = 0;
+    switch(distribution) {
+      case UNIFORM:
+        population = uniform(generator);
+        break;
+      case ZIPF: {
+        long long rank = std::lower_bound(zipf.begin(), zipf.end(), unit(generator)) - zipf.begin();
+        population = MAX_POPULATION / (std::min<long long>(rank, zipf.size() - 1) + 1);
+        break;
+      }
+      case SORTED:
+        population = row * MAX_POPULATION / std::max<long long>(1, rows - 1);
+        break;
+      case REVERSE:
+        population = MAX_POPULATION - row * MAX_POPULATION / std::max<long long>(1, rows - 1);
+        break;
+      case ORGAN_PIPE:
+        population = (row < half ? row : rows - 1 - row) * MAX_POPULATION / half;
+        break;
+      case FEW_UNIQUE:
+        population = fewUnique(generator) * (MAX_POPULATION / 16);
+        break;
+    }
+    appendCityName(out, row);
+    out += ';';
+    out.append(digits, std::to_chars(digits, digits + sizeof(digits), population).ptr - digits);
+    out += "\r\n";
+  }
+}
+
+/**
+ * @brief The main function that generates the dataset.
+ * @param argc Number of command line arguments.
+ * @param argv Array of command line argument strings.
+ * @return 0 if successful, 1 otherwise.
+ */
+int main(int argc, char **argv) {
+  if(argc < 4 || argc > 6) {
+    std::cout << "Usage: ./PopulationGenerator [OutputFileName].csv [Rows] [uniform | zipf | sorted | reverse | organpipe | fewunique] "
+              << "[Seed (335)] [Threads (all cores)]" << std::endl;
+    return 1;
+  }
+  std::string output_file_name = argv[1];
+  long long rows;
+  unsigned long long seed;
+  int threads;
+  Distribution distribution;
+  try {
+    rows = std::stoll(argv[2]);
+    seed = argc >= 5 ? std::stoull(argv[4]) : 335;
+    threads = argc == 6 ? std::stoi(argv[5]) : std::max(1u, std::thread::hardware_concurrency());
+  }
+  catch(std::exception &error) { // not a number
+    std::cout << "Rows, Seed and Threads must be integers !" << std::endl;
+    return 1;
+  }
+  if(output_file_name.size() < 5 || output_file_name.compare(output_file_name.size() - 4, 4, ".csv") != 0) {
+    std::cout << "OutputFileName must end with '.csv' !" << std::endl;
+    return 1;
+  }
+  if(!parseDistribution(argv[3], distribution)) {
+    std::cout << "Distribution must be 'uniform', 'zipf', 'sorted', 'reverse', 'organpipe' or 'fewunique' !" << std::endl;
+    return 1;
+  }
+  if(rows < 1 || threads < 1) {
+    std::cout << "Rows and Threads must be positive !" << std::endl;
+    return 1;
+  }
+
+  std::ofstream file(output_file_name, std::ios::out | std::ios::trunc | std::ios::binary); // open file in trunc mode to overwrite, create if not exists
+  if(!file.is_open()) {
+    std::cout << "File could not be opened !" << std::endl; // check whether the file is opened
+    return 1;
+  }
+  file.write("\xEF\xBB\xBF", 3); // UTF-8 BOM, as in the shipped files
+
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<double> zipf;
+  if(distribution == ZIPF) {
+    zipf = zipfCumulative(std::min<long long>(rows, 1 << 20));
+  }
+  std::vector<std::string> buffers(threads);
+  for(long long batch = 0; batch < rows; batch += threads * CHUNK_ROWS) {
+    std::vector<std::thread> workers;
+    for(int t = 0; t < threads; t++) {
+      long long first = batch + t * CHUNK_ROWS;
+      long long count = std::max<long long>(0, std::min(CHUNK_ROWS, rows - first));
+      workers.emplace_back([&, t, first, count]() {
+        formatChunk(buffers[t], first, count, rows, distribution, seed, zipf);
+      });
+    }
+    for(int t = 0; t < threads; t++) {
+      workers[t].join();
+      file.write(buffers[t].data(), buffers[t].size()); // chunks are written in order
+    }
+  }
+  file.close();
+  auto end = std::chrono::high_resolution_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start); // in nanoseconds
+
+  if(!file) {
+    std::cout << "File could not be written !" << std::endl;
+    return 1;
+  }
+  std::cout << "Generated " << rows << " rows (" << argv[3] << ") in " << duration.count() << " ns." << std::endl;
+  return 0;
+}
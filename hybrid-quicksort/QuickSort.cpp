@@ -15,6 +15,22 @@
 #include <regex>
 #include <fstream>
 #include <chrono>
+#include <ctime>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cmath>
+#include <iterator>
+
+/**
+ * @brief Statistics are compiled in only when QUICKSORT_STATS is defined (e.g. g++ -DQUICKSORT_STATS QuickSort.cpp).
+ * Otherwise QUICKSORT_STAT expands to nothing, so the sorting functions do no extra work.
+ */
+#ifdef QUICKSORT_STATS
+#define QUICKSORT_STAT(statement) statement
+#else
+#define QUICKSORT_STAT(statement)
+#endif
 
 /**
  * @brief Represents a population data structure for sorting.
@@ -26,26 +42,142 @@ struct Population {
 };
 
 /**
- * @brief Represents a logger entry for logging purposes.
+ * @brief Represents one partition in the binary trace, written to the trace file as it is.
+ *
+ * The array contents are not stored; TraceExpand replays the partitions on the input file to render them.
+ */
+struct TraceRecord {
+  int depth;      ///< Recursion depth of the partition, 0 for the whole array
+  int head;       ///< Index of the head of the partitioned sub-range
+  int tail;       ///< Index of the tail of the partitioned sub-range
+  int pivotIndex; ///< Index of the chosen pivot before it is swapped to the tail
+  int pivot;      ///< Pivot value
+};
+
+/**
+ * @brief Describes how sorted an input already is, measured by measurePresortedness.
+ */
+struct Presortedness {
+  int runs;           ///< Number of maximal non-decreasing or strictly decreasing runs
+  long long descents; ///< Number of adjacent pairs out of order, the inversions between neighbours
+  bool nearlySorted;  ///< True if the runs are long enough for runAdaptiveSort to pay off
+};
+
+/**
+ * @brief Records the partitions in a fixed-size buffer that is flushed to the trace file whenever it fills up.
+ *
+ * Memory stays bounded by the buffer whatever the input size, and each partition costs one record instead of a
+ * copy of its sub-range.
+ */
+class PartitionTrace {
+public:
+  /**
+   * @brief Opens the trace file and writes its magic number.
+   * @param fileName The name of the trace file.
+   * @return True if the file is opened, otherwise false.
+   */
+  bool open(const std::string fileName);
+
+  /**
+   * @brief Appends a partition to the buffer, flushing the buffer first if it is full.
+   * @param depth Recursion depth of the partition.
+   * @param head Index of the head of the sub-range.
+   * @param tail Index of the tail of the sub-range.
+   * @param pivotIndex Index of the chosen pivot before it is swapped to the tail.
+   * @param pivot Pivot value.
+   */
+  void record(int depth, int head, int tail, int pivotIndex, int pivot);
+
+  /**
+   * @brief Flushes the remaining records and closes the trace file.
+   */
+  void close();
+
+private:
+  static const int capacity = 4096; ///< Number of records buffered before a write
+  TraceRecord buffer[capacity];     ///< Records not yet written
+  int count = 0;                    ///< Number of records in the buffer
+  std::ofstream file;               ///< The trace file
+
+  /**
+   * @brief Writes the buffered records to the trace file and empties the buffer.
+   */
+  void flush();
+};
+
+PartitionTrace partitionTrace; // global partition trace, only written when verbose is given
+
+/**
+ * @brief Seedable xoshiro256** generator for the random pivot strategies.
+
+ * Much faster than rand() and without shared state: every thread owns its generator (pivotRandom is thread_local),
+ * and a thread is seeded with its own stream number so parallel sorts stay reproducible from a single seed.
  */
-struct Logger{ // created for logging
-  Logger(int pivot, std::string array) : pivot(pivot), array(array) {}
-  int pivot;          ///< Pivot value
-  std::string array;  ///< String representation of an array
+class PivotRandom {
+public:
+  /**
+   * @brief Constructor that seeds the generator with seed 0 and stream 0, seed replaces it.
+   */
+  PivotRandom() { seed(0, 0); }
+
+  /**
+   * @brief Seeds the generator, the state is expanded from the seed and stream with splitmix64.
+   * @param value The seed.
+   * @param stream The stream number, e.g. the index of the thread.
+   */
+  void seed(uint64_t value, uint64_t stream);
+
+  /**
+   * @brief Gets the next 64 random bits.
+   * @return The random bits.
+   */
+  uint64_t next();
+
+  /**
+   * @brief Gets a uniformly distributed integer in [0, bound) without modulo bias (Lemire's method).
+   * @param bound The exclusive upper bound, positive.
+   * @return The random integer.
+   */
+  int below(int bound);
+
+private:
+  uint64_t state[4]; ///< State of the generator, never all zero
 };
 
-std::vector<Logger> logger; // global logger vector
+thread_local PivotRandom pivotRandom; // generator of the random pivots, one per thread
+
+bool networkLeaves = true; // global leaf kernel switch, false sorts the leaves with the plain insertion sort
 
 // int COMPARISON_COUNT = 0; // global comparison count
 
-// Utility functions
+#ifdef QUICKSORT_STATS
+/**
+ * @brief Counters collected by the sorting functions built with QUICKSORT_STATS.
+ */
+struct SortStats {
+  long long comparisons = 0; ///< Comparisons between two populations, including pivot selection, leaves and merges
+  long long swaps = 0;       ///< Swaps of two records
+  long long moves = 0;       ///< Records copied or moved one at a time, a swap counts as 3
+  int maxDepth = 0;          ///< Deepest recursion depth of the quicksort, 0 for the whole array
+  long long partitions = 0;  ///< Number of partitions
+  double balanceSum = 0;     ///< Sum of the partition balances, the smaller side over the other elements (0.5 is a perfect split)
+  double worstBalance = 0.5; ///< Lowest partition balance
+};
+
+thread_local SortStats sortStats; // sorting statistics of the current thread, so parallel sorts do not race on them
 
 /**
- * @brief Converts a vector of Population to a string.
- * @param vec The vector to be converted.
- * @return The string representation of the vector.
+ * @brief Writes the statistics of the run to a JSON file, one object per run.
+ * @param fileName The name of the JSON file.
+ * @param algorithm The name of the sorting algorithm that ran.
+ * @param pivotType Type of pivot selection strategy of the run.
+ * @param threshold Threshold of the run.
+ * @param size Number of sorted elements.
  */
-std::string vectorToString(std::vector<Population> vec);
+void writeStatsJson(const std::string fileName, const std::string algorithm, char pivotType, int threshold, size_t size);
+#endif
+
+// Utility functions
 
 /**
  * @brief Swaps two elements in a vector.
@@ -63,6 +195,24 @@ void quickSwap(std::vector<Population> &vec, int i1, int i2);
  */
 bool validateArguments(int argc, char **argv);
 
+/**
+ * @brief Removes the "--seed N" option from the command line arguments if it is given.
+ * @param argc Number of command line arguments, decreased by the removed ones.
+ * @param argv Array of command line argument strings, the remaining ones are moved to the front.
+ * @param seed The given seed, left as it is when the option is missing.
+ * @return False if the option has no valid seed, otherwise true.
+ */
+bool extractSeed(int &argc, char **argv, uint64_t &seed);
+
+/**
+ * @brief Removes a flag without a value, e.g. "--adaptive", from the command line arguments if it is given.
+ * @param argc Number of command line arguments, decreased by the removed ones.
+ * @param argv Array of command line argument strings, the remaining ones are moved to the front.
+ * @param flag The flag to remove.
+ * @return True if the flag was given, otherwise false.
+ */
+bool extractFlag(int &argc, char **argv, const std::string flag);
+
 // Sorting functions
 
 /**
@@ -73,25 +223,97 @@ bool validateArguments(int argc, char **argv);
  * @param vec The vector to be sorted.
  * @param head Index of the head of the vector.
  * @param tail Index of the tail of the vector.
- * @param pivotType Type of pivot selection strategy ('l' for last, 'r' for random, 'm' for median of three).
+ * @param pivotType Type of pivot selection strategy ('l' for last, 'r' for random, 'm' for median of three, 'n' for ninther or sampled median).
  * @param verbose If true, log the sorting process.
+ * @param depth Recursion depth of this call, 0 for the whole array.
  */
-void naiveQuickSort(std::vector<Population> &vec, int head, int tail, char pivotType, bool verbose);
+void naiveQuickSort(std::vector<Population> &vec, int head, int tail, char pivotType, bool verbose, int depth = 0);
 
 /**
  * @brief Sorts a vector using the hybrid QuickSort algorithm.
 
  * The hybrid QuickSort algorithm determines the pivot by pivotType and then recursively call itself 
- * until the subarray size is lower of equals to the threshold, if so, sort the array using insertionSort.
+ * until the subarray size is lower of equals to the threshold, if so, sort the array using leafSort.
 
  * @param vec The vector to be sorted.
  * @param head Index of the head of the vector.
  * @param tail Index of the tail of the vector.
  * @param threshold Threshold for switching to insertion sort.
- * @param pivotType Type of pivot selection strategy ('l' for last, 'r' for random, 'm' for median of three).
+ * @param pivotType Type of pivot selection strategy ('l' for last, 'r' for random, 'm' for median of three, 'n' for ninther or sampled median).
  * @param verbose If true, log the sorting process.
+ * @param depth Recursion depth of this call, 0 for the whole array.
+ */
+void hybridQuickSort(std::vector<Population> &vec, int head, int tail, int threshold, char pivotType, bool verbose, int depth = 0);
+
+/**
+ * @brief Sorts a vector the way the command line asks for, as main does.
+
+ * 's' selects stableSort, threshold 1 naiveQuickSort and any other threshold hybridQuickSort. With adaptive, the
+ * presortedness pre-pass runs first and a nearly sorted input is sorted by runAdaptiveSort instead.
+
+ * @param vec The vector to be sorted.
+ * @param pivotType Type of pivot selection strategy, or 's' for the stable merge sort.
+ * @param threshold Threshold for switching to the leaf sort, 1 for the naive quicksort.
+ * @param verbose If true, log the partitioning process.
+ * @param adaptive If true, nearly sorted inputs are merged by runs instead of sorted with the requested strategy.
+ * @param presortedness Filled with the result of the pre-pass, all zero without adaptive.
+ * @return The name of the algorithm that sorted the vector: "run-adaptive mergesort", "mergesort",
+ *         "naive quicksort" or "hybrid quicksort".
+ */
+std::string sortPopulations(std::vector<Population> &vec, char pivotType, int threshold, bool verbose, bool adaptive, Presortedness &presortedness);
+
+/**
+ * @brief Sorts a vector stably using a top-down merge sort, selected with the pivot strategy 's'.
+
+ * Cities with equal populations keep their input order. Sub-ranges up to the threshold are sorted by leafSort,
+ * which is stable, and sorted halves are merged through a buffer of at most half of the vector.
+
+ * @param vec The vector to be sorted.
+ * @param threshold Threshold for switching to leafSort.
+ */
+void stableSort(std::vector<Population> &vec, int threshold);
+
+/**
+ * @brief Measures the existing runs and adjacent inversions of a vector in a single pass.
+
+ * A run is a maximal non-decreasing sequence or a maximal strictly decreasing one, the same runs runAdaptiveSort
+ * finds. An input counts as nearly sorted when its runs are 32 elements long on average.
+
+ * @param vec The vector to be measured.
+ * @return The measured presortedness.
+ */
+Presortedness measurePresortedness(const std::vector<Population> &vec);
+
+/**
+ * @brief Sorts a vector stably by merging its existing runs in the order given by powersort.
+
+ * Decreasing runs are reversed and runs shorter than 32 elements are extended with binaryInsertionSort. Each run is
+ * merged with its neighbour as soon as their boundary is shallower than the next one in the powersort merge tree,
+ * so an input made of r runs is sorted with O(n log r) comparisons, close to O(n) for nearly sorted data.
+
+ * @param vec The vector to be sorted.
+ */
+void runAdaptiveSort(std::vector<Population> &vec);
+
+/**
+ * @brief Picks the insertion sort threshold for the 'auto' mode from the profile file, calibrating it if needed.
+
+ * Profiles are keyed by key type, pivot strategy and record size, so a cutoff found for one kind of input is never
+ * reused for another pivot strategy or for records of a different size. A calibrated threshold is appended to the profile file for later runs.
+
+ * @param vec The vector to be sorted, a sample of it is used for calibration.
+ * @param pivotType Type of pivot selection strategy used for the calibration.
+ * @return The threshold.
  */
-void hybridQuickSort(std::vector<Population> &vec, int head, int tail, int threshold, char pivotType, bool verbose);
+int autoThreshold(const std::vector<Population> &vec, char pivotType);
+
+/**
+ * @brief Finds the fastest insertion sort threshold on this machine by timing the sort on a shuffled sample.
+ * @param vec The vector to be sorted, a sample of it is used for calibration.
+ * @param pivotType Type of pivot selection strategy used for the calibration.
+ * @return The threshold with the lowest sorting time.
+ */
+int calibrateThreshold(const std::vector<Population> &vec, char pivotType);
 
 // IO functions
 
@@ -109,26 +331,27 @@ void readFromCsv(const std::string fileName, std::vector<Population> &vec);
  */
 void writeToCsv(const std::string fileName, const std::vector<Population> &vec);
 
-/**
- * @brief Writes logger data to a file.
- * @param fileName The name of the file.
- * @param vec The vector containing logger data.
- */
-void writeLogger(const std::string fileName, const std::vector<Logger> &vec);
-
 /**
  * @brief The main function that orchestrates the sorting process based on command line arguments.
  * @param argc Number of command line arguments.
  * @param argv Array of command line argument strings.
  * @return 0 if successful, 1 otherwise.
  */
+#ifndef QUICKSORT_NO_MAIN // defined by the tools that include this file for its sorting functions
 int main(int argc, char **argv) {
-  std::srand(std::time(nullptr)); // seed for random number generator
+  uint64_t seed = std::time(nullptr); // seed for random number generator, fixed with --seed to repeat a run
+  if(!extractSeed(argc, argv, seed)) {
+    std::cout << "Seed must be a non-negative integer, e.g. --seed 335 !" << std::endl;
+    return 1;
+  }
+  ::pivotRandom.seed(seed, 0); // the main thread is stream 0
+  bool adaptive = extractFlag(argc, argv, "--adaptive"); // merge the runs of nearly sorted inputs instead
 
   std::string input_file_name;
   std::string output_file_name;
   char pivot_strategy;
   int threshold;
+  bool auto_threshold;
   bool verbose;
 
   if(!validateArguments(argc, argv)) { // validate command line arguments
@@ -136,7 +359,8 @@ int main(int argc, char **argv) {
   }else{
     input_file_name = argv[1];
     pivot_strategy = argv[2][0];
-    threshold = std::stoi(argv[3]);
+    auto_threshold = std::string(argv[3]) == "auto";
+    threshold = auto_threshold ? 0 : std::stoi(argv[3]); // auto threshold is picked after reading the data
     output_file_name = argv[4];
     if(argc == 6){ // if verbose is given
       verbose = true;   
@@ -144,23 +368,40 @@ int main(int argc, char **argv) {
       verbose = false;
     }
   }
+  if(adaptive && verbose) {
+    std::cout << "Verbose can not be used with --adaptive, the run-adaptive MergeSort is not traced !" << std::endl;
+    return 1;
+  }
 
   std::vector<Population> population_data; // created for population data
 
   readFromCsv(input_file_name, population_data); // read from csv
 
-  if(threshold == 1){ // if threshold is 1, use naive quicksort
-    auto start = std::chrono::high_resolution_clock::now();
-    naiveQuickSort(population_data, 0, population_data.size() - 1, pivot_strategy, verbose);
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start); // in nanoseconds
-    std::cout << "Time taken by QuickSort with pivot strategy \'" << std::string(1, pivot_strategy) // print the output in desired format
-              << "\' and threshold " << threshold << ": " << duration.count() << " ns." << std::endl;
-  } else{ // otherwise use hybrid quicksort
-    auto start = std::chrono::high_resolution_clock::now();
-    hybridQuickSort(population_data, 0, population_data.size() - 1, threshold, pivot_strategy, verbose);
-    auto end = std::chrono::high_resolution_clock::now();
-    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start); // in nanoseconds
+  if(auto_threshold && adaptive && measurePresortedness(population_data).nearlySorted) {
+    std::cout << "Auto threshold: not calibrated, the input is merged by runs" << std::endl; // the threshold is not used
+  } else if(auto_threshold) {
+    threshold = autoThreshold(population_data, pivot_strategy);
+    std::cout << "Auto threshold: " << threshold << std::endl;
+    QUICKSORT_STAT(::sortStats = SortStats()); // the calibration sorts are not part of the run
+  }
+
+  if(verbose && !::partitionTrace.open("log.trace")) { // partitions are traced while sorting, TraceExpand turns the trace into log.txt
+    return 1;
+  }
+
+  Presortedness presortedness{0, 0, false}; // filled by the pre-pass
+  auto start = std::chrono::high_resolution_clock::now();
+  std::string algorithm = sortPopulations(population_data, pivot_strategy, threshold, verbose, adaptive, presortedness);
+  auto end = std::chrono::high_resolution_clock::now();
+  auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start); // in nanoseconds, with the pre-pass
+  if(algorithm == "run-adaptive mergesort"){
+    std::cout << "Input is nearly sorted, pivot strategy \'" << std::string(1, pivot_strategy) << "\' and threshold "
+              << (auto_threshold ? "auto" : std::to_string(threshold)) << " are replaced by run-adaptive MergeSort (--adaptive)." << std::endl;
+    std::cout << "Time taken by run-adaptive MergeSort on " << presortedness.runs << " runs (" << presortedness.descents
+              << " descents): " << duration.count() << " ns." << std::endl;
+  } else if(algorithm == "mergesort"){
+    std::cout << "Time taken by stable MergeSort with threshold " << threshold << ": " << duration.count() << " ns." << std::endl;
+  } else{
     std::cout << "Time taken by QuickSort with pivot strategy \'" << std::string(1, pivot_strategy) // print the output in desired format
               << "\' and threshold " << threshold << ": " << duration.count() << " ns." << std::endl;
   }
@@ -168,19 +409,24 @@ int main(int argc, char **argv) {
   writeToCsv(output_file_name, population_data); // write to csv
 
   if(verbose){
-    writeLogger("log.txt", ::logger); // write logger to file if verbose is given
+    ::partitionTrace.close(); // flush the remaining partitions to the trace file
   }
 
   // std::cout << "Total comparison made by quicksort : " << COMPARISON_COUNT << std::endl; // print the total comparison count
+#ifdef QUICKSORT_STATS
+  std::cout << "Comparisons: " << ::sortStats.comparisons << ", max recursion depth: " << ::sortStats.maxDepth << std::endl;
+  writeStatsJson("stats.json", algorithm, pivot_strategy, threshold, population_data.size()); // next to log.txt
+#endif
   return 0;
 }
+#endif
 
 // Sorting functions
 
 /**
  * @brief Sorts a vector using the insertion sort algorithm.
 
- * The insertion sort algorithm sorts the vector in place when threshold condition is satisfied in hybridQuickSort.
+ * The insertion sort algorithm sorts the vector in place, it is the leaf kernel of hybridQuickSort when networkLeaves is false.
 
  * @param vec The vector to be sorted.
  * @param head Index of the head of the vector.
@@ -190,27 +436,158 @@ void insertionSort(std::vector<Population> &vec, int head, int tail) {
   for (int i = head + 1; i <= tail; i++) {
     Population key = vec[i];
     int j = i - 1;
-    while (j >= 0 && vec[j].population > key.population) {
+    while (j >= head && vec[j].population > key.population) {
       vec[j + 1] = vec[j];
       j--;
     }
+    QUICKSORT_STAT(::sortStats.comparisons += (i - 1 - j) + (j >= head ? 1 : 0)); // one per shift, one more for the stop
+    QUICKSORT_STAT(::sortStats.moves += (i - 1 - j) + 2); // the shifts, the copy of the key and its placement
     vec[j + 1] = key;
   }
 }
 
+/**
+ * @brief Comparators of the sorting networks used for the leaves, applied in order as (i, j) index pairs.
+
+ * Networks with the least known compare-exchanges for 4, 8 and 16 inputs (5, 19 and 60). A leaf is padded
+ * up to the next network size with keys larger than any real key, so the padding stays at the end.
+ */
+const unsigned char network4[][2] = {{0, 1}, {2, 3}, {0, 2}, {1, 3}, {1, 2}};
+const unsigned char network8[][2] = {
+  {0, 2}, {1, 3}, {4, 6}, {5, 7}, {0, 4}, {1, 5}, {2, 6}, {3, 7}, {0, 1}, {2, 3}, {4, 5}, {6, 7},
+  {2, 4}, {3, 5}, {1, 4}, {3, 6}, {1, 2}, {3, 4}, {5, 6}};
+const unsigned char network16[][2] = {
+  {0, 13}, {1, 12}, {2, 15}, {3, 14}, {4, 8}, {5, 6}, {7, 11}, {9, 10},
+  {0, 5}, {1, 7}, {2, 9}, {3, 4}, {6, 13}, {8, 14}, {10, 15}, {11, 12},
+  {0, 1}, {2, 3}, {4, 5}, {6, 8}, {7, 9}, {10, 11}, {12, 13}, {14, 15},
+  {0, 2}, {1, 3}, {4, 10}, {5, 11}, {6, 7}, {8, 9}, {12, 14}, {13, 15},
+  {1, 2}, {3, 12}, {4, 6}, {5, 7}, {8, 10}, {9, 11}, {13, 14},
+  {1, 4}, {2, 6}, {5, 8}, {7, 10}, {9, 13}, {11, 14},
+  {2, 4}, {3, 6}, {9, 12}, {11, 13},
+  {3, 5}, {6, 8}, {7, 9}, {10, 12},
+  {3, 4}, {5, 6}, {7, 8}, {9, 10}, {11, 12},
+  {6, 7}, {8, 9}};
+
+/**
+ * @brief Applies a sorting network to the keys, every compare-exchange is a branchless min/max.
+ * @param keys The keys to be sorted, at least as many as the network has inputs.
+ * @param network The comparators of the network.
+ */
+template <size_t N> void applyNetwork(uint64_t *keys, const unsigned char (&network)[N][2]) {
+  for(size_t c = 0; c < N; c++) {
+    uint64_t a = keys[network[c][0]];
+    uint64_t b = keys[network[c][1]];
+    keys[network[c][0]] = std::min(a, b);
+    keys[network[c][1]] = std::max(a, b);
+  }
+  QUICKSORT_STAT(::sortStats.comparisons += N);
+}
+
+/**
+ * @brief Sorts at most 16 elements with a sorting network.
+
+ * The network sorts 64-bit keys made of the population (high half, sign flipped so the unsigned order matches)
+ * and the offset of the element (low half), so it never touches the records and equal populations keep their order.
+ * The records are then moved into place by following the cycles of the resulting permutation.
+
+ * @param vec The vector to be sorted.
+ * @param head Index of the head of the vector.
+ * @param tail Index of the tail of the vector, at most head + 15.
+ */
+void networkSort(std::vector<Population> &vec, int head, int tail) {
+  int size = tail - head + 1;
+  uint64_t keys[16];
+  for(int i = 0; i < 16; i++) {
+    keys[i] = i < size ? static_cast<uint64_t>(static_cast<uint32_t>(vec[head + i].population) ^ 0x80000000u) << 32 | i : UINT64_MAX;
+  }
+  if(size <= 4) {
+    applyNetwork(keys, network4);
+  } else if(size <= 8) {
+    applyNetwork(keys, network8);
+  } else {
+    applyNetwork(keys, network16);
+  }
+
+  int source[16]; // source[k] is the offset of the element that belongs to offset k
+  for(int k = 0; k < size; k++) {
+    source[k] = static_cast<int>(keys[k] & 0xFFFFFFFF);
+  }
+  for(int start = 0; start < size; start++) {
+    if(source[start] == start) {continue;} // already in place or moved by an earlier cycle
+    Population temp = std::move(vec[head + start]);
+    int k = start;
+    while(source[k] != start) {
+      vec[head + k] = std::move(vec[head + source[k]]);
+      QUICKSORT_STAT(::sortStats.moves++);
+      int next = source[k];
+      source[k] = k;
+      k = next;
+    }
+    vec[head + k] = std::move(temp);
+    source[k] = k;
+    QUICKSORT_STAT(::sortStats.moves += 2); // temp in and out, the others are counted in the loop
+  }
+}
+
+/**
+ * @brief Sorts a vector using insertion sort with a binary search for the insertion point.
+
+ * Used for the leaves too large for a sorting network, it makes O(n log n) comparisons and moves the records
+ * instead of copying them.
+
+ * @param vec The vector to be sorted.
+ * @param head Index of the head of the vector.
+ * @param tail Index of the tail of the vector.
+ */
+void binaryInsertionSort(std::vector<Population> &vec, int head, int tail) {
+  for(int i = head + 1; i <= tail; i++) {
+    auto position = std::upper_bound(vec.begin() + head, vec.begin() + i, vec[i].population,
+                                     [](int population, const Population &other) {
+                                       QUICKSORT_STAT(::sortStats.comparisons++);
+                                       return population < other.population;
+                                     });
+    if(position == vec.begin() + i) {continue;} // already after every smaller element
+    Population key = std::move(vec[i]);
+    std::move_backward(position, vec.begin() + i, vec.begin() + i + 1);
+    *position = std::move(key);
+    QUICKSORT_STAT(::sortStats.moves += (vec.begin() + i - position) + 2);
+  }
+}
+
+/**
+ * @brief Sorts a leaf of hybridQuickSort, with a sorting network up to 16 elements and binary insertion sort above.
+
+ * When networkLeaves is false, the plain insertionSort is used instead, so both kernels can be compared.
+
+ * @param vec The vector to be sorted.
+ * @param head Index of the head of the vector.
+ * @param tail Index of the tail of the vector.
+ */
+void leafSort(std::vector<Population> &vec, int head, int tail) {
+  if(!::networkLeaves) {
+    insertionSort(vec, head, tail);
+  } else if(tail - head + 1 <= 16) {
+    networkSort(vec, head, tail);
+  } else {
+    binaryInsertionSort(vec, head, tail);
+  }
+}
+
 /**
  * @brief Partitions the vector using the last element as the pivot.
 
  * Base partition function for all pivot selection strategies, determines the last element as pivot.
- * If verbose is true, then logs the partitioning process.
+ * If verbose is true, then records the partition in the trace.
 
  * @param vec The vector to be partitioned.
  * @param head Index of the head of the vector.
  * @param tail Index of the tail of the vector.
  * @param verbose If true, log the partitioning process.
+ * @param depth Recursion depth of the partition.
+ * @param pivotIndex Index the pivot was swapped to the tail from, tail when the last element is the pivot.
  * @return The index of the pivot after partitioning.
  */
-int lastPartition(std::vector<Population> &vec, int head, int tail, bool verbose){
+int lastPartition(std::vector<Population> &vec, int head, int tail, bool verbose, int depth, int pivotIndex){
   Population pivot = vec[tail]; // last element as pivot
   int i = head;
   for(int j = head; j <= tail; j++) {
@@ -220,11 +597,19 @@ int lastPartition(std::vector<Population> &vec, int head, int tail, bool verbose
     }
   }
   // COMPARISON_COUNT+=2 * (tail - head + 1) + 1; // total comparison by if and for blocks
+  QUICKSORT_STAT(::sortStats.comparisons += tail - head + 1);
+  QUICKSORT_STAT(::sortStats.moves++); // the copy of the pivot
+#ifdef QUICKSORT_STATS
+  if(tail > head) {
+    double balance = static_cast<double>(std::min(i - head, tail - i)) / (tail - head);
+    ::sortStats.partitions++;
+    ::sortStats.balanceSum += balance;
+    ::sortStats.worstBalance = std::min(::sortStats.worstBalance, balance);
+  }
+#endif
   quickSwap(vec, i, tail);
   if(verbose) {
-    auto start = vec.begin() + head;
-    auto end = vec.begin() + tail + 1;
-    ::logger.push_back(Logger(vec[i].population, vectorToString(std::vector<Population>(start, end)))); // log the partitioning process
+    ::partitionTrace.record(depth, head, tail, pivotIndex, vec[i].population); // log the partitioning process
   }
   return i;
 }
@@ -238,12 +623,13 @@ int lastPartition(std::vector<Population> &vec, int head, int tail, bool verbose
  * @param head Index of the head of the vector.
  * @param tail Index of the tail of the vector.
  * @param verbose If true, log the partitioning process.
+ * @param depth Recursion depth of the partition.
  * @return The index of the pivot after partitioning.
  */
-int randomPartition(std::vector<Population> &vec, int head, int tail, bool verbose){
-  int pivot = rand() % (tail - head + 1) + head; // random pivot
+int randomPartition(std::vector<Population> &vec, int head, int tail, bool verbose, int depth){
+  int pivot = ::pivotRandom.below(tail - head + 1) + head; // random pivot
   quickSwap(vec, pivot, tail); // swap pivot with last element
-  return lastPartition(vec, head, tail, verbose); // partition with last element as pivot
+  return lastPartition(vec, head, tail, verbose, depth, pivot); // partition with last element as pivot
 }
 
 /**
@@ -255,83 +641,365 @@ int randomPartition(std::vector<Population> &vec, int head, int tail, bool verbo
  * @param head Index of the head of the vector.
  * @param tail Index of the tail of the vector.
  * @param verbose If true, log the partitioning process.
+ * @param depth Recursion depth of the partition.
  * @return The index of the pivot after partitioning.
  */
-int median3Partition(std::vector<Population> &vec, int head, int tail, bool verbose){
-  int pivot1 = rand() % (tail - head + 1) + head;
-  int pivot2 = rand() % (tail - head + 1) + head;
-  int pivot3 = rand() % (tail - head + 1) + head;
+int median3Partition(std::vector<Population> &vec, int head, int tail, bool verbose, int depth){
+  int pivot1 = ::pivotRandom.below(tail - head + 1) + head;
+  int pivot2 = ::pivotRandom.below(tail - head + 1) + head;
+  int pivot3 = ::pivotRandom.below(tail - head + 1) + head;
   int median;
 
   if(vec[pivot1].population <= vec[pivot2].population && vec[pivot1].population >= vec[pivot3].population) {median = pivot1;} 
   else if(vec[pivot2].population <= vec[pivot1].population && vec[pivot2].population >= vec[pivot3].population) {median = pivot2;}  // find median of three random elements
   else {median = pivot3;}
   // COMPARISON_COUNT+=4; // total comparison by if blocks
+  QUICKSORT_STAT(::sortStats.comparisons += 4); // at most 4 evaluated by the if blocks
+
+  quickSwap(vec, median, tail); // swap median with last element
+  return lastPartition(vec, head, tail, verbose, depth, median); // partition with last element as pivot
+}
+
+/**
+ * @brief Finds the index of the median of three elements.
+ * @param vec The vector containing the elements.
+ * @param a Index of the first element.
+ * @param b Index of the second element.
+ * @param c Index of the third element.
+ * @return The index of the median element.
+ */
+int medianOf3(const std::vector<Population> &vec, int a, int b, int c) {
+  auto less = [&vec](int x, int y) {
+    QUICKSORT_STAT(::sortStats.comparisons++);
+    return vec[x].population < vec[y].population;
+  };
+  if(less(a, b)) {
+    if(less(b, c)) {return b;}
+    return less(a, c) ? c : a;
+  }
+  if(less(a, c)) {return a;}
+  return less(b, c) ? c : b;
+}
+
+/**
+ * @brief Partitions the vector using a pivot sampled in proportion to the size of the sub-range.
+
+ * Small sub-ranges take the median of three random elements, medium ones the ninther (Tukey): the median of
+ * the medians of three groups of three elements spread evenly over the sub-range, and large ones the median of
+ * about sqrt(n) random elements. The pivot is swapped with the last element, then lastPartition is called.
+
+ * @param vec The vector to be partitioned.
+ * @param head Index of the head of the vector.
+ * @param tail Index of the tail of the vector.
+ * @param verbose If true, log the partitioning process.
+ * @param depth Recursion depth of the partition.
+ * @return The index of the pivot after partitioning.
+ */
+int samplePartition(std::vector<Population> &vec, int head, int tail, bool verbose, int depth){
+  const int nintherSize = 40;       // smallest sub-range that uses the ninther
+  const int sqrtSampleSize = 16384; // smallest sub-range that uses a sqrt(n) sample
+  int size = tail - head + 1;
+  int median;
+  if(size < nintherSize) {
+    median = medianOf3(vec, ::pivotRandom.below(size) + head, ::pivotRandom.below(size) + head, ::pivotRandom.below(size) + head);
+  } else if(size < sqrtSampleSize) {
+    int step = (size - 1) / 8; // leaves at least one start position
+    int start = head + ::pivotRandom.below(size - 8 * step); // random offset of the evenly spaced elements
+    median = medianOf3(vec, medianOf3(vec, start, start + step, start + 2 * step),
+                            medianOf3(vec, start + 3 * step, start + 4 * step, start + 5 * step),
+                            medianOf3(vec, start + 6 * step, start + 7 * step, start + 8 * step));
+  } else {
+    int sampleCount = static_cast<int>(std::sqrt(static_cast<double>(size))) | 1; // odd, so the median is an element
+    std::vector<int> sample(sampleCount);
+    for(int i = 0; i < sampleCount; i++) {
+      sample[i] = ::pivotRandom.below(size) + head;
+    }
+    std::nth_element(sample.begin(), sample.begin() + sampleCount / 2, sample.end(), [&vec](int a, int b) {
+      QUICKSORT_STAT(::sortStats.comparisons++);
+      return vec[a].population < vec[b].population;
+    });
+    median = sample[sampleCount / 2];
+  }
 
   quickSwap(vec, median, tail); // swap median with last element
-  return lastPartition(vec, head, tail, verbose); // partition with last element as pivot
+  return lastPartition(vec, head, tail, verbose, depth, median); // partition with last element as pivot
 }
 
-void naiveQuickSort(std::vector<Population> &vec, int head, int tail, char pivotType, bool verbose) {
+void naiveQuickSort(std::vector<Population> &vec, int head, int tail, char pivotType, bool verbose, int depth) {
+  QUICKSORT_STAT(::sortStats.maxDepth = std::max(::sortStats.maxDepth, depth));
   if(head < tail) {
     int pivot;
     switch(pivotType) {
       case 'l':
-        pivot = lastPartition(vec, head, tail, verbose); // last element as pivot
+        pivot = lastPartition(vec, head, tail, verbose, depth, tail); // last element as pivot
         break;
       case 'r': 
-        pivot = randomPartition(vec, head, tail, verbose); // random element as pivot
+        pivot = randomPartition(vec, head, tail, verbose, depth); // random element as pivot
         break;
       case 'm':
-        pivot = median3Partition(vec, head, tail, verbose); // median of three random elements as pivot
+        pivot = median3Partition(vec, head, tail, verbose, depth); // median of three random elements as pivot
+        break;
+      case 'n':
+        pivot = samplePartition(vec, head, tail, verbose, depth); // ninther or sampled median as pivot
+        break;
+      default: // unknown strategies fall back to the last element
+        pivot = lastPartition(vec, head, tail, verbose, depth, tail);
         break;
     }
-    naiveQuickSort(vec, head, pivot - 1, pivotType, verbose);
-    naiveQuickSort(vec, pivot + 1, tail, pivotType, verbose);
+    naiveQuickSort(vec, head, pivot - 1, pivotType, verbose, depth + 1);
+    naiveQuickSort(vec, pivot + 1, tail, pivotType, verbose, depth + 1);
   }
   // COMPARISON_COUNT+=4; // total comparison by if and switch blocks
 }
 
-void hybridQuickSort(std::vector<Population> &vec, int head, int tail, int threshold, char pivotType, bool verbose) {
+void hybridQuickSort(std::vector<Population> &vec, int head, int tail, int threshold, char pivotType, bool verbose, int depth) {
+  QUICKSORT_STAT(::sortStats.maxDepth = std::max(::sortStats.maxDepth, depth));
   if(head < tail) {
     int pivot;
-    if(tail - head + 1 <= threshold) { // if size of the vector is less than or equal to threshold, use insertion sort
-      insertionSort(vec, head, tail);
+    if(tail - head + 1 <= threshold) { // if size of the vector is less than or equal to threshold, sort it as a leaf
+      leafSort(vec, head, tail);
     }
     else { // otherwise use hybrid quicksort
       switch(pivotType) {
         case 'l':
-          pivot = lastPartition(vec, head, tail, verbose); // last element as pivot
+          pivot = lastPartition(vec, head, tail, verbose, depth, tail); // last element as pivot
           break;
         case 'r': 
-          pivot = randomPartition(vec, head, tail, verbose); // random element as pivot
+          pivot = randomPartition(vec, head, tail, verbose, depth); // random element as pivot
           break;
         case 'm':
-          pivot = median3Partition(vec, head, tail, verbose); // median of three random elements as pivot
+          pivot = median3Partition(vec, head, tail, verbose, depth); // median of three random elements as pivot
+          break;
+        case 'n':
+          pivot = samplePartition(vec, head, tail, verbose, depth); // ninther or sampled median as pivot
+          break;
+        default: // unknown strategies fall back to the last element
+          pivot = lastPartition(vec, head, tail, verbose, depth, tail);
           break;
       }
-      hybridQuickSort(vec, head, pivot - 1, threshold, pivotType, verbose);
-      hybridQuickSort(vec, pivot + 1, tail, threshold, pivotType, verbose);
+      hybridQuickSort(vec, head, pivot - 1, threshold, pivotType, verbose, depth + 1);
+      hybridQuickSort(vec, pivot + 1, tail, threshold, pivotType, verbose, depth + 1);
     }
   }
 }
 
-// Utility functions
+/**
+ * @brief Merges the sorted sub-ranges [head, middle] and [middle + 1, tail] stably.
+
+ * The elements already in their final place are trimmed first: the head of the left run that is not greater than
+ * the first element of the right run, and the tail of the right run that is not less than the last element of the
+ * left run. Only the rest of the left run is moved to the buffer.
+
+ * @param vec The vector containing the sub-ranges.
+ * @param head Index of the head of the left run.
+ * @param middle Index of the tail of the left run.
+ * @param tail Index of the tail of the right run.
+ * @param buffer Scratch space, reused between merges.
+ */
+void mergeRuns(std::vector<Population> &vec, int head, int middle, int tail, std::vector<Population> &buffer) {
+  auto byPopulation = [](const Population &element, int population) {
+    QUICKSORT_STAT(::sortStats.comparisons++);
+    return element.population < population;
+  };
+  QUICKSORT_STAT(::sortStats.comparisons++);
+  if(vec[middle].population <= vec[middle + 1].population) {return;} // already in order
+  head = std::upper_bound(vec.begin() + head, vec.begin() + middle + 1, vec[middle + 1].population,
+                          [](int population, const Population &element) {
+                            QUICKSORT_STAT(::sortStats.comparisons++);
+                            return population < element.population;
+                          }) - vec.begin();
+  tail = std::lower_bound(vec.begin() + middle + 1, vec.begin() + tail + 1, vec[middle].population, byPopulation) - vec.begin() - 1;
+
+  buffer.clear();
+  std::move(vec.begin() + head, vec.begin() + middle + 1, std::back_inserter(buffer));
+  QUICKSORT_STAT(::sortStats.moves += buffer.size());
+  size_t i = 0;
+  int j = middle + 1;
+  int k = head;
+  while(i < buffer.size() && j <= tail) {
+    if(vec[j].population < buffer[i].population) { // strict, so equal populations are taken from the left run first
+      vec[k++] = std::move(vec[j++]);
+    } else {
+      vec[k++] = std::move(buffer[i++]);
+    }
+  }
+  QUICKSORT_STAT(::sortStats.comparisons += i + (j - middle - 1)); // one per step of the loop above
+  while(i < buffer.size()) {
+    vec[k++] = std::move(buffer[i++]);
+  }
+  QUICKSORT_STAT(::sortStats.moves += k - head); // every assignment above
+}
+
+/**
+ * @brief Sorts a sub-range stably using the top-down merge sort.
+ * @param vec The vector to be sorted.
+ * @param head Index of the head of the vector.
+ * @param tail Index of the tail of the vector.
+ * @param threshold Threshold for switching to leafSort.
+ * @param buffer Scratch space for mergeRuns.
+ */
+void mergeSort(std::vector<Population> &vec, int head, int tail, int threshold, std::vector<Population> &buffer) {
+  if(tail - head + 1 <= std::max(threshold, 1)) {
+    leafSort(vec, head, tail);
+    return;
+  }
+  int middle = head + (tail - head) / 2;
+  mergeSort(vec, head, middle, threshold, buffer);
+  mergeSort(vec, middle + 1, tail, threshold, buffer);
+  mergeRuns(vec, head, middle, tail, buffer);
+}
+
+/**
+ * @brief Finds the run starting at the given index, reversing it if it is strictly decreasing.
+
+ * Only strictly decreasing runs are reversed, so equal populations never change their order.
+
+ * @param vec The vector containing the run.
+ * @param head Index of the head of the run.
+ * @return Index of the tail of the run.
+ */
+int findRun(std::vector<Population> &vec, int head) {
+  int last = vec.size() - 1;
+  int tail = head;
+  if(tail < last && vec[tail + 1].population < vec[tail].population) {
+    while(tail < last && vec[tail + 1].population < vec[tail].population) {tail++;}
+    std::reverse(vec.begin() + head, vec.begin() + tail + 1);
+    QUICKSORT_STAT(::sortStats.swaps += (tail - head + 1) / 2);
+    QUICKSORT_STAT(::sortStats.moves += 3 * ((tail - head + 1) / 2));
+  } else {
+    while(tail < last && vec[tail + 1].population >= vec[tail].population) {tail++;}
+  }
+  QUICKSORT_STAT(::sortStats.comparisons += (head < last) + (tail - head) + (tail < last)); // the direction, the run and its end
+  return tail;
+}
+
+/**
+ * @brief Computes the powersort depth of the boundary between two neighbouring runs.
+
+ * The depth is the first bit where the midpoints of the two runs differ, both scaled to [0, 1) of the whole vector.
+
+ * @param head1 Index of the head of the left run.
+ * @param size1 Size of the left run.
+ * @param size2 Size of the right run.
+ * @param size Size of the whole vector.
+ * @return The depth of the boundary, shallow boundaries are merged last.
+ */
+int runBoundaryPower(long long head1, long long size1, long long size2, long long size) {
+  long long a = 2 * head1 + size1;  // twice the midpoint of the left run
+  long long b = a + size1 + size2;  // twice the midpoint of the right run
+  int power = 0;
+  while(true) {
+    power++;
+    if(a >= size) { // both midpoints have this bit set
+      a -= size;
+      b -= size;
+    } else if(b >= size) { // the midpoints differ in this bit
+      break;
+    }
+    a <<= 1;
+    b <<= 1;
+  }
+  return power;
+}
 
-std::string vectorToString(std::vector<Population> vec) {
-  std::string str = "[";
-  for (size_t i = 0; i < vec.size(); i++) {
-    if(i == vec.size() - 1) {
-      str += std::to_string(vec[i].population) + "]"; // last element
+Presortedness measurePresortedness(const std::vector<Population> &vec) {
+  const int minAverageRun = 32;
+  Presortedness result{0, 0, false};
+  int size = vec.size();
+  for(int i = 0; i + 1 < size; i++) {
+    if(vec[i + 1].population < vec[i].population) {result.descents++;}
+  }
+  QUICKSORT_STAT(::sortStats.comparisons += std::max(size - 1, 0));
+  int head = 0;
+  while(head < size) { // same runs as findRun, without reversing them
+    int tail = head;
+    if(tail + 1 < size && vec[tail + 1].population < vec[tail].population) {
+      while(tail + 1 < size && vec[tail + 1].population < vec[tail].population) {tail++;}
     } else {
-      str += std::to_string(vec[i].population) + ", "; // other elements
+      while(tail + 1 < size && vec[tail + 1].population >= vec[tail].population) {tail++;}
+    }
+    QUICKSORT_STAT(::sortStats.comparisons += (head + 1 < size) + (tail - head) + (tail + 1 < size));
+    result.runs++;
+    head = tail + 1;
+  }
+  result.nearlySorted = size > 1 && static_cast<long long>(result.runs) * minAverageRun <= size;
+  return result;
+}
+
+void runAdaptiveSort(std::vector<Population> &vec) {
+  struct Run { // a run waiting on the merge stack, with the depth of its boundary to the next run
+    int head;
+    int tail;
+    int power;
+  };
+  const int minRun = 32;
+  int size = vec.size();
+  if(size < 2) {return;}
+
+  std::vector<Population> buffer;
+  std::vector<Run> stack; // the powers are increasing from the bottom, so it holds O(log n) runs
+  Run current{0, findRun(vec, 0), 0};
+  if(current.tail - current.head + 1 < minRun) { // extend short runs, the existing part is already sorted
+    current.tail = std::min(current.head + minRun, size) - 1;
+    binaryInsertionSort(vec, current.head, current.tail);
+  }
+  while(current.tail < size - 1) {
+    Run next{current.tail + 1, findRun(vec, current.tail + 1), 0};
+    if(next.tail - next.head + 1 < minRun) {
+      next.tail = std::min(next.head + minRun, size) - 1;
+      binaryInsertionSort(vec, next.head, next.tail);
     }
+    int power = runBoundaryPower(current.head, current.tail - current.head + 1, next.tail - next.head + 1, size);
+    while(!stack.empty() && stack.back().power > power) { // deeper boundaries are merged first
+      mergeRuns(vec, stack.back().head, stack.back().tail, current.tail, buffer);
+      current.head = stack.back().head;
+      stack.pop_back();
+    }
+    current.power = power;
+    stack.push_back(current);
+    current = next;
+  }
+  while(!stack.empty()) {
+    mergeRuns(vec, stack.back().head, stack.back().tail, current.tail, buffer);
+    current.head = stack.back().head;
+    stack.pop_back();
+  }
+}
+
+void stableSort(std::vector<Population> &vec, int threshold) {
+  if(vec.size() < 2) {return;}
+  std::vector<Population> buffer;
+  buffer.reserve(vec.size() / 2 + 1); // a left run is at most half of the vector
+  mergeSort(vec, 0, vec.size() - 1, threshold, buffer);
+}
+
+std::string sortPopulations(std::vector<Population> &vec, char pivotType, int threshold, bool verbose, bool adaptive, Presortedness &presortedness) {
+  presortedness = Presortedness{0, 0, false};
+  if(adaptive) {
+    presortedness = measurePresortedness(vec); // runs and inversions, in O(n)
+  }
+  if(presortedness.nearlySorted) { // nearly sorted input, merge the existing runs instead
+    runAdaptiveSort(vec);
+    return "run-adaptive mergesort";
   }
-  return str;
+  if(pivotType == 's') { // stable sort mode, the threshold is the leaf size of the merge sort
+    stableSort(vec, threshold);
+    return "mergesort";
+  }
+  if(threshold == 1) { // if threshold is 1, use naive quicksort
+    naiveQuickSort(vec, 0, vec.size() - 1, pivotType, verbose);
+    return "naive quicksort";
+  }
+  hybridQuickSort(vec, 0, vec.size() - 1, threshold, pivotType, verbose); // otherwise use hybrid quicksort
+  return "hybrid quicksort";
 }
 
+// Utility functions
+
 void quickSwap(std::vector<Population> &vec, int i1, int i2){
   if(i1 == i2) {return;}
+  QUICKSORT_STAT(::sortStats.swaps++);
+  QUICKSORT_STAT(::sortStats.moves += 3);
   Population temp = vec[i1];
   vec[i1] = vec[i2];
   vec[i2] = temp;
@@ -339,20 +1007,22 @@ void quickSwap(std::vector<Population> &vec, int i1, int i2){
 
 bool validateArguments(int argc, char **argv) {
   if (argc < 5 || argc > 6) {
-    std::cout << "Usage: ./QuickSort [DatasetFileName].csv [PivotStrategy] [Threshold] [OutputFileName].csv [Verbose]"  // any usage error, print usage
+    std::cout << "Usage: ./QuickSort [DatasetFileName].csv [PivotStrategy] [Threshold | auto] [OutputFileName].csv [Verbose] [--seed N] [--adaptive]"  // any usage error, print usage
               << std::endl; 
     return false;
   }
-  if(argv[2][0] != 'l' && argv[2][0] != 'r' && argv[2][0] != 'm') {
-    std::cout << "PivotStrategy must be 'l'(last), 'r'(random) or 'm'(median) !" << std::endl; 
+  if(argv[2][0] != 'l' && argv[2][0] != 'r' && argv[2][0] != 'm' && argv[2][0] != 'n' && argv[2][0] != 's') {
+    std::cout << "PivotStrategy must be 'l'(last), 'r'(random), 'm'(median), 'n'(ninther) or 's'(stable merge sort) !" << std::endl; 
     return false;
   }
 
   try{
-    std::stoi(argv[3]); // try to convert threshold to integer
+    if(std::string(argv[3]) != "auto") {
+      std::stoi(argv[3]); // try to convert threshold to integer
+    }
   }
   catch(std::invalid_argument &error) { // if not an integer, print error
-    std::cout << "Threshold must be an integer !" << std::endl; 
+    std::cout << "Threshold must be an integer or 'auto' !" << std::endl; 
     return false;
   }
 
@@ -363,12 +1033,174 @@ bool validateArguments(int argc, char **argv) {
   }
 
   if(argc == 6 && argv[5][0] != 'v') {
-    std::cout << "Verbose must be given as 'v' !" << std::endl; 
+    std::cout << "Verbose must be given as 'v' !" << std::endl;
     return false;
   }
+  if(argc == 6 && argv[2][0] == 's') { // the trace records partitions, the merge sort has none
+    std::cout << "Verbose can not be used with 's', the stable merge sort is not traced !" << std::endl;
+    return false;
+  }
+  return true;
+}
+
+int calibrateThreshold(const std::vector<Population> &vec, char pivotType) {
+  const int candidates[] = {2, 4, 8, 12, 16, 24, 32, 48, 64};
+  const int sampleSize = std::min<int>(4096, vec.size());
+  const int repetitions = 5;
+
+  std::vector<Population> sample; // evenly spaced elements of the input, shuffled so a sorted input is not favoured
+  for(int i = 0; i < sampleSize; i++) {
+    sample.push_back(vec[static_cast<long long>(i) * vec.size() / sampleSize]);
+  }
+  std::mt19937 generator(335);
+  std::shuffle(sample.begin(), sample.end(), generator);
+
+  int best = candidates[0];
+  long long bestTime = -1;
+  for(int threshold : candidates) {
+    long long fastest = -1; // the fastest repetition is the least disturbed by the rest of the system
+    for(int r = 0; r < repetitions; r++) {
+      std::vector<Population> copy = sample;
+      auto start = std::chrono::high_resolution_clock::now();
+      if(pivotType == 's') {
+        stableSort(copy, threshold);
+      } else {
+        hybridQuickSort(copy, 0, copy.size() - 1, threshold, pivotType, false);
+      }
+      auto end = std::chrono::high_resolution_clock::now();
+      long long duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+      if(fastest < 0 || duration < fastest) {
+        fastest = duration;
+      }
+    }
+    if(bestTime < 0 || fastest < bestTime) {
+      bestTime = fastest;
+      best = threshold;
+    }
+  }
+  return best;
+}
+
+int autoThreshold(const std::vector<Population> &vec, char pivotType) {
+  const std::string profileName = "threshold.profile"; // next to log.txt, one "<key type> <record bytes> <threshold>" line per profile
+  if(vec.size() < 2) {
+    return 1;
+  }
+
+  size_t nameBytes = 0;
+  for(size_t i = 0; i < vec.size(); i++) {
+    nameBytes += vec[i].city.capacity() > 15 ? vec[i].city.capacity() + 1 : 0; // short strings live inside the record
+  }
+  int recordBytes = (sizeof(Population) + nameBytes / vec.size() + 7) / 8 * 8; // rounded up to 8 bytes
+  const std::string keyType = pivotType == 's' ? "int-stable" : "int-" + std::string(1, pivotType); // every strategy has its own cutoff
+
+  std::ifstream profile(profileName);
+  std::string profileKeyType;
+  int profileRecordBytes, profileThreshold;
+  while(profile >> profileKeyType >> profileRecordBytes >> profileThreshold) {
+    if(profileKeyType == keyType && profileRecordBytes == recordBytes) {
+      return profileThreshold; // calibrated by an earlier run
+    }
+  }
+  profile.close();
+
+  int threshold = calibrateThreshold(vec, pivotType);
+  std::ofstream output(profileName, std::ios::out | std::ios::app); // keep the profiles of other record sizes
+  if(output.is_open()) {
+    output << keyType << " " << recordBytes << " " << threshold << "\n";
+  }
+  return threshold;
+}
+
+bool extractSeed(int &argc, char **argv, uint64_t &seed) {
+  int kept = 1;
+  for(int i = 1; i < argc; i++) {
+    if(std::string(argv[i]) != "--seed") {
+      argv[kept++] = argv[i];
+      continue;
+    }
+    if(i + 1 >= argc || !std::regex_match(argv[i + 1], std::regex("^[0-9]+$"))) {
+      return false;
+    }
+    try {
+      seed = std::stoull(argv[++i]);
+    }
+    catch(std::out_of_range &error) { // more than 64 bits
+      return false;
+    }
+  }
+  argc = kept;
   return true;
 }
 
+bool extractFlag(int &argc, char **argv, const std::string flag) {
+  int kept = 1;
+  bool found = false;
+  for(int i = 1; i < argc; i++) {
+    if(std::string(argv[i]) == flag) {
+      found = true;
+    } else {
+      argv[kept++] = argv[i];
+    }
+  }
+  argc = kept;
+  return found;
+}
+
+void PivotRandom::seed(uint64_t value, uint64_t stream) {
+  uint64_t x = value ^ (stream * 0xD1B54A32D192ED03ull); // different streams start from different splitmix64 states
+  for(int i = 0; i < 4; i++) {
+    x += 0x9E3779B97F4A7C15ull;
+    uint64_t z = x;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    state[i] = z ^ (z >> 31);
+  }
+}
+
+uint64_t PivotRandom::next() {
+  auto rotateLeft = [](uint64_t x, int k) { return (x << k) | (x >> (64 - k)); };
+  uint64_t result = rotateLeft(state[1] * 5, 7) * 9;
+  uint64_t t = state[1] << 17;
+  state[2] ^= state[0];
+  state[3] ^= state[1];
+  state[1] ^= state[2];
+  state[0] ^= state[3];
+  state[2] ^= t;
+  state[3] = rotateLeft(state[3], 45);
+  return result;
+}
+
+int PivotRandom::below(int bound) {
+  uint32_t range = bound;
+  uint64_t product = (next() >> 32) * range; // the high 32 bits of the product are the result
+  uint32_t low = static_cast<uint32_t>(product);
+  if(low < range) { // only then the result may be biased
+    uint32_t rejected = -range % range; // 2^32 mod range, the low halves below it are rejected
+    while(low < rejected) {
+      product = (next() >> 32) * range;
+      low = static_cast<uint32_t>(product);
+    }
+  }
+  return static_cast<int>(product >> 32);
+}
+
+#ifdef QUICKSORT_STATS
+void writeStatsJson(const std::string fileName, const std::string algorithm, char pivotType, int threshold, size_t size) {
+  std::ofstream file(fileName, std::ios::out | std::ios::trunc); // open file in trunc mode to overwrite, create if not exists
+  if(!file.is_open()) {
+    std::cout << "File could not be opened !" << std::endl; // check whether the file is opened
+    return;
+  }
+  const SortStats &stats = ::sortStats;
+  file << "{\"algorithm\": \"" << algorithm << "\", \"pivot\": \"" << pivotType << "\", \"threshold\": " << threshold
+       << ", \"size\": " << size << ", \"comparisons\": " << stats.comparisons << ", \"swaps\": " << stats.swaps
+       << ", \"moves\": " << stats.moves << ", \"max_depth\": " << stats.maxDepth << ", \"partitions\": " << stats.partitions
+       << ", \"mean_balance\": " << (stats.partitions > 0 ? stats.balanceSum / stats.partitions : 0.5)
+       << ", \"worst_balance\": " << stats.worstBalance << "}\n";
+}
+#endif
+
 // IO functions
 
 void readFromCsv(const std::string fileName, std::vector<Population> &vec) {
@@ -402,15 +1234,30 @@ void writeToCsv(const std::string fileName, const std::vector<Population> &vec)
   }
 }
 
-void writeLogger(const std::string fileName, const std::vector<Logger> &vec) {
-  std::ofstream file(fileName, std::ios::out | std::ios::trunc); // open file in trunc mode to overwrite, create if not exists
+bool PartitionTrace::open(const std::string fileName) {
+  file.open(fileName, std::ios::out | std::ios::trunc | std::ios::binary); // open file in trunc mode to overwrite, create if not exists
   if(!file.is_open()) {
     std::cout << "File could not be opened !" << std::endl; // check whether the file is opened
-    return;
+    return false;
   }
-  for(size_t i = 0; i < vec.size(); i++) {
-    std::string line = "Pivot: " + std::to_string(vec[i].pivot) + " Array: " + vec[i].array + "\n"; // write logger to file in desired format
-    file << line;
+  file.write("QST1", 4); // magic number checked by TraceExpand
+  count = 0;
+  return true;
+}
+
+void PartitionTrace::record(int depth, int head, int tail, int pivotIndex, int pivot) {
+  if(count == capacity) {
+    flush(); // buffer is full, write it out and reuse it
   }
+  buffer[count++] = TraceRecord{depth, head, tail, pivotIndex, pivot};
+}
+
+void PartitionTrace::flush() {
+  file.write(reinterpret_cast<const char *>(buffer), count * sizeof(TraceRecord));
+  count = 0;
 }
 
+void PartitionTrace::close() {
+  flush();
+  file.close();
+}
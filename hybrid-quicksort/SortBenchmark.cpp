@@ -0,0 +1,307 @@
+/**
+  BLG335E - Analysis of Algorithms I - Project 1
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+/**
+ * @file SortBenchmark.cpp
+ * @brief This file benchmarks every sorting algorithm of Project 1 and Project 2 on the same datasets.
+ *
+ * The algorithms are the QuickSort of the command line with every pivot strategy and threshold, its --adaptive
+ * path (the presortedness pre-pass and the run-adaptive merge sort for nearly sorted inputs), the insertion sort leaves
+ * against the sorting network leaves, the stable merge sort, heapsort and dary_heapsort with several d. The datasets are population1..4.csv from the Data folder and synthetic
+ * random, sorted, reversed and duplicate-heavy inputs of the given sizes.
+ *
+ * Every case runs once as a warm-up and is then timed the given number of times on a fresh copy of the input, with
+ * the process pinned to one CPU. A case whose warm-up takes longer than a second is timed once. The last element
+ * pivot is skipped on nearly sorted inputs above LINEAR_DEPTH_ROWS rows, where it recurses once per row and overflows
+ * the stack. The median, minimum and maximum are printed and written to benchmark.csv and benchmark.json, which are
+ * rewritten after every result so a crashing case does not lose the results before it.
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <regex>
+#include <fstream>
+#include <chrono>
+#include <ctime>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <cstdint>
+#include <climits>
+#include <cmath>
+#include <iterator>
+#include <sched.h>
+
+const long long SLOW_RUN_NS = 1000000000; // a case whose warm-up takes longer is timed only once
+const size_t LINEAR_DEPTH_ROWS = 20000;   // largest nearly sorted input the last element pivot is run on
+
+#define QUICKSORT_NO_MAIN // only the sorting functions of QuickSort.cpp are used
+#include "QuickSort.cpp"
+
+// HeapSort.cpp is included inside a namespace, so every standard header it includes must already be included above
+#define HEAPSORT_NO_MAIN // only the heap functions of HeapSort.cpp are used
+namespace HEAP { // HeapSort.cpp has its own Population and quickSwap
+#include "../heapsort/HeapSort.cpp"
+}
+
+/**
+ * @brief Represents one input of the benchmark.
+ */
+struct Dataset {
+  std::string name;                ///< File name or synthetic kind with its size
+  std::vector<Population> rows;    ///< Rows for the QuickSort functions
+  std::vector<HEAP::Population> heapRows; ///< The same rows for the heap functions
+};
+
+/**
+ * @brief Represents the timings of one algorithm on one dataset.
+ */
+struct Result {
+  std::string dataset;   ///< Name of the dataset
+  size_t size;           ///< Number of rows
+  std::string algorithm; ///< Name of the algorithm, as sortPopulations reports it for QuickSort
+  std::string variant;   ///< Pivot strategy, leaf kernel or d of the algorithm
+  int threshold;         ///< Threshold of QuickSort or the merge sort, 0 for the heaps
+  int runs;              ///< Number of timed runs, 1 for a slow case
+  long long median;      ///< Median time in nanoseconds
+  long long minimum;     ///< Fastest time in nanoseconds
+  long long maximum;     ///< Slowest time in nanoseconds
+};
+
+/**
+ * @brief Checks whether a vector is sorted by population.
+ * @param vec The vector to be checked.
+ * @return True if the vector is sorted, otherwise false.
+ */
+template <class Row> bool isSorted(const std::vector<Row> &vec) {
+  for(size_t i = 1; i < vec.size(); i++) {
+    if(vec[i - 1].population > vec[i].population) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Runs a sort once as a warm-up and then the given number of times, each on a fresh copy of the input.
+ * @param input The input, copied for each run.
+ * @param repetitions Number of timed runs, only one if the warm-up is slower than SLOW_RUN_NS.
+ * @param sort The sort to run on the copy.
+ * @param times Filled with the time of each timed run in nanoseconds, empty if a result is not sorted.
+ */
+template <class Row> void timeSort(const std::vector<Row> &input, int repetitions, const std::function<void(std::vector<Row> &)> &sort,
+                                   std::vector<long long> &times) {
+  times.clear();
+  for(int r = -1; r < repetitions; r++) { // run -1 is the warm-up
+    std::vector<Row> copy = input;
+    auto start = std::chrono::high_resolution_clock::now();
+    sort(copy);
+    auto end = std::chrono::high_resolution_clock::now();
+    if(r == -1 && !isSorted(copy)) {
+      return;
+    }
+    if(r == -1 && end - start > std::chrono::nanoseconds(SLOW_RUN_NS)) {
+      repetitions = 1;
+    }
+    if(r >= 0) {
+      times.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+  }
+}
+
+/**
+ * @brief Creates a synthetic dataset in the format of the population files.
+ * @param kind "random", "sorted", "reversed" or "duplicates" (about sqrt(n) distinct populations).
+ * @param size Number of rows.
+ * @return The dataset.
+ */
+Dataset makeSynthetic(const std::string &kind, int size) {
+  std::mt19937 generator(335);
+  int distinct = kind == "duplicates" ? std::max(1, static_cast<int>(std::sqrt(size))) : 10000000;
+  std::uniform_int_distribution<int> population(0, distinct - 1);
+  std::vector<int> values(size);
+  for(int i = 0; i < size; i++) {
+    values[i] = population(generator);
+  }
+  if(kind == "sorted") {
+    std::sort(values.begin(), values.end());
+  } else if(kind == "reversed") {
+    std::sort(values.rbegin(), values.rend());
+  }
+
+  Dataset dataset;
+  dataset.name = kind + "_" + std::to_string(size);
+  for(int i = 0; i < size; i++) {
+    dataset.rows.push_back(Population{"City" + std::to_string(i) + ";" + std::to_string(values[i]), values[i]});
+  }
+  return dataset;
+}
+
+/**
+ * @brief Writes the results as CSV, one row per algorithm and dataset.
+ * @param fileName The name of the CSV file.
+ * @param results The results.
+ */
+void writeResultsCsv(const std::string fileName, const std::vector<Result> &results) {
+  std::ofstream file(fileName, std::ios::out | std::ios::trunc); // open file in trunc mode to overwrite, create if not exists
+  file << "dataset,size,algorithm,variant,threshold,runs,median_ns,min_ns,max_ns\n";
+  for(const Result &result : results) {
+    file << result.dataset << "," << result.size << "," << result.algorithm << ",\"" << result.variant << "\"," << result.threshold
+         << "," << result.runs << "," << result.median << "," << result.minimum << "," << result.maximum << "\n";
+  }
+}
+
+/**
+ * @brief Writes the results as a JSON array, one object per algorithm and dataset.
+ * @param fileName The name of the JSON file.
+ * @param results The results.
+ * @param repetitions Number of timed runs behind each result.
+ * @param cpu The CPU the benchmark was pinned to, -1 if pinning failed.
+ */
+void writeResultsJson(const std::string fileName, const std::vector<Result> &results, int repetitions, int cpu) {
+  std::ofstream file(fileName, std::ios::out | std::ios::trunc); // open file in trunc mode to overwrite, create if not exists
+  file << "{\"repetitions\": " << repetitions << ", \"warmup\": 1, \"cpu\": " << cpu << ", \"results\": [\n";
+  for(size_t i = 0; i < results.size(); i++) {
+    const Result &result = results[i];
+    file << "  {\"dataset\": \"" << result.dataset << "\", \"size\": " << result.size << ", \"algorithm\": \"" << result.algorithm
+         << "\", \"variant\": \"" << result.variant << "\", \"threshold\": " << result.threshold << ", \"runs\": " << result.runs << ", \"median_ns\": " << result.median
+         << ", \"min_ns\": " << result.minimum << ", \"max_ns\": " << result.maximum << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+  }
+  file << "]}\n";
+}
+
+/**
+ * @brief Times every algorithm on a dataset and appends the results.
+ * @param dataset The dataset.
+ * @param repetitions Number of timed runs of each algorithm.
+ * @param cpu The CPU the benchmark is pinned to, -1 if pinning failed.
+ * @param results The array to append the results to, written to benchmark.csv and benchmark.json after each one.
+ */
+void benchmarkDataset(Dataset &dataset, int repetitions, int cpu, std::vector<Result> &results) {
+  for(const Population &row : dataset.rows) {
+    dataset.heapRows.push_back(HEAP::Population{row.city, row.population});
+  }
+  std::vector<long long> times;
+  auto record = [&](const std::string &algorithm, const std::string &variant, int threshold) {
+    if(times.empty()) {
+      std::cout << dataset.name << " " << algorithm << " " << variant << ": result is not sorted !" << std::endl;
+      return;
+    }
+    std::vector<long long> sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    Result result{dataset.name, dataset.rows.size(), algorithm, variant, threshold, static_cast<int>(sorted.size()),
+                  sorted[sorted.size() / 2], sorted.front(), sorted.back()};
+    std::cout << dataset.name << "\t" << algorithm << "\t" << variant << "\t" << threshold << "\t" << result.median
+              << " ns (min " << result.minimum << ", max " << result.maximum << ", " << result.runs << " runs)" << std::endl;
+    results.push_back(result);
+    writeResultsCsv("benchmark.csv", results); // rewritten every time, so a crash later keeps this result
+    writeResultsJson("benchmark.json", results, repetitions, cpu);
+  };
+
+  const char pivots[] = {'l', 'r', 'm', 'n'};
+  const int thresholds[] = {1, 8, 16, 32, 64};
+  bool linearDepth = dataset.rows.size() > LINEAR_DEPTH_ROWS && measurePresortedness(dataset.rows).nearlySorted;
+  for(char pivot : pivots) { // the quicksort itself, without the --adaptive pre-pass
+    if(pivot == 'l' && linearDepth) { // one partition per row, the recursion would overflow the stack
+      std::cout << dataset.name << " quicksort l: skipped, nearly sorted input above " << LINEAR_DEPTH_ROWS << " rows" << std::endl;
+      continue;
+    }
+    for(int threshold : thresholds) {
+      std::string algorithm;
+      timeSort<Population>(dataset.rows, repetitions, [&](std::vector<Population> &vec) {
+        Presortedness presortedness{0, 0, false};
+        algorithm = sortPopulations(vec, pivot, threshold, false, false, presortedness);
+      }, times);
+      record(algorithm, std::string(1, pivot), threshold);
+    }
+  }
+
+  std::string adaptiveAlgorithm; // --adaptive, the run-adaptive merge sort on nearly sorted inputs, otherwise the quicksort
+  timeSort<Population>(dataset.rows, repetitions, [&](std::vector<Population> &vec) {
+    Presortedness presortedness{0, 0, false};
+    adaptiveAlgorithm = sortPopulations(vec, 'n', 16, false, true, presortedness);
+  }, times);
+  record(adaptiveAlgorithm, "n, --adaptive", 16);
+
+  for(int threshold : {8, 16, 32, 64}) { // leaf kernels, without the pre-pass so the leaves are always reached
+    for(bool network : {false, true}) {
+      ::networkLeaves = network;
+      timeSort<Population>(dataset.rows, repetitions, [&](std::vector<Population> &vec) {
+        hybridQuickSort(vec, 0, vec.size() - 1, threshold, 'n', false);
+      }, times);
+      record("hybrid quicksort", network ? "n, network leaves" : "n, insertion leaves", threshold);
+    }
+  }
+  ::networkLeaves = true;
+
+  timeSort<Population>(dataset.rows, repetitions, [](std::vector<Population> &vec) { stableSort(vec, 16); }, times);
+  record("mergesort", "s", 16);
+
+  timeSort<HEAP::Population>(dataset.heapRows, repetitions, [](std::vector<HEAP::Population> &vec) {
+    HEAP::heapsort_in_place(vec, vec.size());
+  }, times);
+  record("heapsort", "d=2", 0);
+
+  for(int d : {2, 3, 4, 8}) {
+    timeSort<HEAP::Population>(dataset.heapRows, repetitions, [d](std::vector<HEAP::Population> &vec) {
+      HEAP::dary_heapsort_in_place(vec, vec.size(), d);
+    }, times);
+    record("dary_heapsort", "d=" + std::to_string(d), 0);
+  }
+  dataset.heapRows.clear();
+}
+
+/**
+ * @brief The main function that runs the benchmark suite.
+ * @param argc Number of command line arguments.
+ * @param argv Array of command line argument strings.
+ * @return 0 if successful, 1 otherwise.
+ */
+int main(int argc, char **argv) {
+  if(argc > 4) {
+    std::cout << "Usage: ./SortBenchmark [Repetitions (5)] [SyntheticSizes (100000), comma separated] [CPU (0)]" << std::endl;
+    return 1;
+  }
+  int repetitions = argc >= 2 ? std::stoi(argv[1]) : 5;
+  std::string size_list = argc >= 3 ? argv[2] : "100000";
+  int cpu = argc == 4 ? std::stoi(argv[3]) : 0;
+  if(repetitions < 1) {
+    std::cout << "Repetitions must be positive !" << std::endl;
+    return 1;
+  }
+
+  cpu_set_t cpus; // pin to one CPU, so the runs are not moved between cores
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+  if(sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+    std::cout << "Could not pin to CPU " << cpu << ", running unpinned." << std::endl;
+    cpu = -1;
+  }
+  ::pivotRandom.seed(335, 0); // the same pivots in every run of the benchmark
+
+  std::vector<Result> results;
+  for(int n = 1; n <= 4; n++) {
+    Dataset dataset;
+    dataset.name = "population" + std::to_string(n);
+    readFromCsv(dataset.name + ".csv", dataset.rows);
+    if(!dataset.rows.empty()) {
+      benchmarkDataset(dataset, repetitions, cpu, results);
+    }
+  }
+  std::stringstream sizes(size_list);
+  std::string size;
+  while(std::getline(sizes, size, ',')) {
+    for(const std::string kind : {"random", "sorted", "reversed", "duplicates"}) {
+      Dataset dataset = makeSynthetic(kind, std::stoi(size));
+      benchmarkDataset(dataset, repetitions, cpu, results);
+    }
+  }
+
+  std::cout << results.size() << " results written to benchmark.csv and benchmark.json" << std::endl;
+  return 0;
+}
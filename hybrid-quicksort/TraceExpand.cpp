@@ -0,0 +1,128 @@
+/**
+  BLG335E - Analysis of Algorithms I - Project 1
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+/**
+ * @file TraceExpand.cpp
+ * @brief This file expands a binary partition trace of QuickSort into the log.txt format.
+ *
+ * QuickSort with 'v' records only (depth, head, tail, pivot index, pivot) per partition. The array contents
+ * are rendered here instead, by replaying the recorded partitions on the input file: every partition sees
+ * exactly the sub-range QuickSort saw, since insertion sort only touches sub-ranges that are never partitioned.
+ */
+#include <iostream>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <fstream>
+#include <cstring>
+
+/**
+ * @brief Represents one partition in the binary trace, same layout as in QuickSort.cpp.
+ */
+struct TraceRecord {
+  int depth;      ///< Recursion depth of the partition, 0 for the whole array
+  int head;       ///< Index of the head of the partitioned sub-range
+  int tail;       ///< Index of the tail of the partitioned sub-range
+  int pivotIndex; ///< Index of the chosen pivot before it is swapped to the tail
+  int pivot;      ///< Pivot value
+};
+
+/**
+ * @brief Reads the populations from a CSV file in the Data folder, in the same way as QuickSort.
+ * @param fileName The name of the CSV file.
+ * @param vec The vector to store the populations.
+ * @return True if the file is read, otherwise false.
+ */
+bool readPopulations(const std::string fileName, std::vector<int> &vec) {
+  std::ifstream file("./Data/" + fileName); // data folder is in the same directory as the executable
+  if(!file.is_open()) {
+    std::cout << "File could not be opened !" << std::endl; // check whether the file is opened
+    return false;
+  }
+  std::string line;
+  while(std::getline(file, line)) {
+    std::stringstream ss(line);
+    std::string item;
+    std::vector<std::string> row;
+    while(std::getline(ss, item, ';')) {
+      row.push_back(item); // split the line by ';' and push to vector to get the second element
+    }
+    vec.push_back(std::stoi(row[1])); // convert population(second item) to integer
+  }
+  return true;
+}
+
+/**
+ * @brief Replays one recorded partition exactly as lastPartition does it.
+ * @param vec The populations.
+ * @param record The recorded partition.
+ * @return The index of the pivot after partitioning.
+ */
+int replayPartition(std::vector<int> &vec, const TraceRecord &record) {
+  std::swap(vec[record.pivotIndex], vec[record.tail]); // the pivot strategy moved the pivot to the tail
+  int pivot = vec[record.tail];
+  int i = record.head;
+  for(int j = record.head; j <= record.tail; j++) {
+    if(vec[j] < pivot){
+      std::swap(vec[i], vec[j]);
+      i++;
+    }
+  }
+  std::swap(vec[i], vec[record.tail]);
+  return i;
+}
+
+/**
+ * @brief The main function that expands the trace into the log file.
+ * @param argc Number of command line arguments.
+ * @param argv Array of command line argument strings.
+ * @return 0 if successful, 1 otherwise.
+ */
+int main(int argc, char **argv) {
+  if (argc < 2 || argc > 4) {
+    std::cout << "Usage: ./TraceExpand [DatasetFileName].csv [TraceFileName (log.trace)] [LogFileName (log.txt)]" << std::endl;
+    return 1;
+  }
+  std::string trace_file_name = argc >= 3 ? argv[2] : "log.trace";
+  std::string log_file_name = argc == 4 ? argv[3] : "log.txt";
+
+  std::vector<int> populations;
+  if(!readPopulations(argv[1], populations)) {
+    return 1;
+  }
+
+  std::ifstream trace(trace_file_name, std::ios::binary);
+  char magic[4];
+  if(!trace.read(magic, 4) || std::memcmp(magic, "QST1", 4) != 0) {
+    std::cout << "Trace file could not be read !" << std::endl;
+    return 1;
+  }
+  std::ofstream log(log_file_name, std::ios::out | std::ios::trunc); // open file in trunc mode to overwrite, create if not exists
+  if(!log.is_open()) {
+    std::cout << "File could not be opened !" << std::endl; // check whether the file is opened
+    return 1;
+  }
+
+  TraceRecord record;
+  while(trace.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+    if(record.head < 0 || record.tail >= static_cast<int>(populations.size()) || record.pivotIndex < record.head || record.pivotIndex > record.tail) {
+      std::cout << "Trace does not match the dataset !" << std::endl;
+      return 1;
+    }
+    int pivot = replayPartition(populations, record);
+    if(populations[pivot] != record.pivot) {
+      std::cout << "Trace does not match the dataset !" << std::endl;
+      return 1;
+    }
+    log << "Pivot: " << record.pivot << " Array: ["; // write the partition in the format of log.txt
+    for(int i = record.head; i <= record.tail; i++) {
+      log << populations[i] << (i == record.tail ? "]" : ", ");
+    }
+    log << "\n";
+  }
+  return 0;
+}
@@ -0,0 +1,286 @@
+// Implementing AVL Tree in C++
+// tree_helpers.cpp must be included before this file
+
+/**
+  BLG335E - Analysis of Algorithms I - Project 3
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+#include <iostream>
+#include <algorithm>
+
+/**
+ * @brief Node struct to hold attributes of each node inside a namespace for the AVL Tree.
+ */
+namespace AVL {
+  struct Node {
+    int data;
+    std::string name;
+    int height;   // Number of nodes on the longest path down to a leaf, 1 for a leaf
+    Node *parent;
+    Node *left;
+    Node *right;
+  };
+}
+
+/**
+ * @brief A class representing a height-balanced AVL Tree.
+ *
+ * The heights of the two subtrees of every node differ by at most one, so the tree is at most
+ * about 1.44 log2(n) high, shallower than a Red-Black Tree, at the cost of more rotations on updates.
+ */
+class AVLTree {
+private:
+  AVL::Node *root; // Pointer to the root node of the tree
+  int nodeCount;   // Number of nodes in the tree
+
+  /**
+   * @brief Helper function to get the height stored in a node, where an empty subtree has height 0.
+   * @param node The node whose height is returned.
+   * @return The height of the node.
+   */
+  int heightOf(AVL::Node *node) {
+    return node != nullptr ? node->height : 0;
+  }
+
+  /**
+   * @brief Helper function to recompute the height of a node from its children.
+   * @param node The node whose height is updated.
+   */
+  void updateHeight(AVL::Node *node) {
+    node->height = std::max(heightOf(node->left), heightOf(node->right)) + 1;
+  }
+
+  /**
+  * @brief Performs a left rotation around the given node.
+  * @param x The node around which the left rotation is performed.
+  * @return The node that takes the place of x.
+  */
+  AVL::Node* leftRotate(AVL::Node* x) {
+    AVL::Node* y = TREE::leftRotate(root, x);
+    updateHeight(x);
+    updateHeight(y);
+    return y;
+  }
+
+  /**
+  * @brief Performs a right rotation around the given node.
+  * @param y The node around which the right rotation is performed.
+  * @return The node that takes the place of y.
+  */
+  AVL::Node* rightRotate(AVL::Node* y) {
+    AVL::Node* x = TREE::rightRotate(root, y);
+    updateHeight(y);
+    updateHeight(x);
+    return x;
+  }
+
+  /**
+   * @brief Restores the AVL property on the path from the given node up to the root.
+   *
+   * Heights are updated bottom-up; a node whose subtrees differ by two is fixed with a single rotation,
+   * or a double rotation when the taller child leans the other way.
+   *
+   * @param node The lowest node whose subtree has changed.
+   */
+  void rebalance(AVL::Node *node) {
+    while (node != nullptr) {
+      updateHeight(node);
+      int balance = heightOf(node->left) - heightOf(node->right);
+      if (balance > 1) { // Left heavy
+        if (heightOf(node->left->left) < heightOf(node->left->right)) {
+          leftRotate(node->left); // Left-right case
+        }
+        node = rightRotate(node);
+      } else if (balance < -1) { // Right heavy
+        if (heightOf(node->right->right) < heightOf(node->right->left)) {
+          rightRotate(node->right); // Right-left case
+        }
+        node = leftRotate(node);
+      }
+      node = node->parent;
+    }
+  }
+
+public:
+  /**
+   * @brief Constructor to initialize the root node to null.
+   */
+  AVLTree() {
+    root = nullptr;
+    nodeCount = 0;
+  }
+
+  /**
+   * @brief Destructor to free the memory allocated for nodes in the AVL Tree.
+   */
+  ~AVLTree() {
+    TREE::destroyTree(root);
+  }
+
+  /**
+   * @brief Function to traverse the tree in inorder and store the data in the given array.
+   * @param orderedData The array to store the data in.
+   * @param startIndex The starting index of the array to store the data in, if given as 0 it simply starts the array in 0th index.
+   */
+  void inorder(std::pair<std::string, int> orderedData[], int startIndex) {
+    int index = startIndex;
+    TREE::inorderHelper(root, orderedData, index);
+  }
+
+  /**
+   * @brief Function to search the tree iteratively for a given value.
+   * @param value The value to search for.
+   * @return The node with the given value, if found. Otherwise, returns null.
+   */
+  AVL::Node* searchTree(int value) {
+    return TREE::searchTree(root, value);
+  }
+
+  /**
+  * @brief Find the successor of a node in the AVL Tree (AVL).
+  * @param node The node for which to find the successor.
+  * @return A pointer to the successor node, or nullptr if there is none.
+  */
+  AVL::Node* successor(AVL::Node* node) {
+    return TREE::successor(node);
+  }
+
+  /**
+  * @brief Find the predecessor of a node in the AVL Tree (AVL).
+  * @param node The node for which to find the predecessor.
+  * @return A pointer to the predecessor node, or nullptr if there is none.
+  */
+  AVL::Node* predecessor(AVL::Node* node) {
+    return TREE::predecessor(node);
+  }
+
+  /**
+  * @brief Inserts a new node with the given name and population into the AVL Tree.
+  *
+  * The node is placed as in a Binary Search Tree, equal populations going right, and the heights
+  * on the path back to the root are then rebalanced.
+  *
+  * @param name The name of the city.
+  * @param data The population of the city.
+  * @return The inserted node, which can later be passed to deleteNode.
+  */
+  AVL::Node* insert(const std::string& name, int data) {
+    AVL::Node* z = new AVL::Node;
+    z->name = name;
+    z->data = data;
+    z->left = nullptr;
+    z->right = nullptr;
+    z->height = 1;
+
+    AVL::Node* y = nullptr;
+    AVL::Node* x = root;
+
+    // Traverse the tree to find the appropriate position for the new node, equal keys go right
+    while (x != nullptr) {
+      y = x;
+      x = data < x->data ? x->left : x->right;
+    }
+
+    z->parent = y;
+    if (y == nullptr)
+      root = z;
+    else if (data < y->data)
+      y->left = z;
+    else
+      y->right = z;
+    nodeCount++;
+
+    rebalance(y);
+    return z;
+  }
+
+  /**
+  * @brief Deletes the given node from the AVL Tree.
+  *
+  * The node is removed as in a Binary Search Tree, replaced by its successor when it has two children,
+  * and the tree is rebalanced from the lowest node whose subtree lost a level.
+  *
+  * @param z The node to be deleted, e.g. the result of insert or searchTree. It is freed by this call.
+  */
+  void deleteNode(AVL::Node* z) {
+    if (z == nullptr) {
+      return; // Nothing to delete
+    }
+
+    AVL::Node* start; // Lowest node whose height may have changed
+    if (z->left == nullptr) {
+      start = z->parent;
+      TREE::transplant(root, z, z->right);
+    } else if (z->right == nullptr) {
+      start = z->parent;
+      TREE::transplant(root, z, z->left);
+    } else {
+      AVL::Node* y = TREE::findMin(z->right);
+      if (y->parent != z) {
+        start = y->parent;
+        TREE::transplant(root, y, y->right);
+        y->right = z->right;
+        y->right->parent = y;
+      } else {
+        start = y;
+      }
+      TREE::transplant(root, z, y);
+      y->left = z->left;
+      y->left->parent = y;
+    }
+
+    delete z;
+    nodeCount--;
+    rebalance(start);
+  }
+
+  /**
+  * @brief Deletes a node with the given data from the AVL Tree (AVL).
+  * @param data The data value of the node to be deleted.
+  */
+  void deleteNode(int data) {
+    deleteNode(searchTree(data));
+  }
+
+  /**
+   * @brief Function to get the height of the tree.
+   * @return The height of the tree.
+   */
+  int getHeight() {
+    return TREE::getHeightHelper(root) - 1; // (Count of nodes from top  to bottom) - 1 = height
+  }
+
+  /**
+  * @brief Gets the node with the maximum value in the AVL Tree (AVL).
+  * @return The node with the maximum value, or nullptr if the tree is empty.
+  */
+  AVL::Node *getMaximum() {
+    if (root == nullptr) {
+      return nullptr; // Tree is empty
+    }
+    return TREE::findMax(root);
+  }
+
+  /**
+  * @brief Gets the node with the minimum value in the AVL Tree (AVL).
+  * @return The node with the minimum value, or nullptr if the tree is empty.
+  */
+  AVL::Node *getMinimum() {
+    if (root == nullptr) {
+      return nullptr; // Tree is empty
+    }
+    return TREE::findMin(root);
+  }
+
+  /**
+  * @brief Gets the total number of nodes in the AVL Tree (AVL).
+  * @return The total number of nodes, or 0 if the tree is empty.
+  */
+  int getTotalNodes() {
+    return nodeCount;
+  }
+
+}; // End of AVLTree class
@@ -0,0 +1,337 @@
+#include "rbt.cpp"
+#include "eytzinger.cpp"
+#include "persistent_rbt.cpp"
+#include "concurrent_rbt.cpp"
+#include "compact_rbt.cpp"
+#include "snapshot.cpp"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <cmath>
+#include <algorithm>
+#include <malloc.h>
+
+/**
+ * @brief Reads the cities and populations from the given file in the same way as main.cpp.
+ * @param inputFilename The name of the input file.
+ * @param data The array to store the (city, population) pairs in.
+ * @return True if the file is read, otherwise false.
+ */
+bool readPopulation(const char *inputFilename, std::vector<std::pair<std::string, int>> &data) {
+    std::ifstream file(inputFilename);
+    if (!file) {
+        std::cerr << "Error opening the file." << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t pos = line.find(';');
+        if (pos != std::string::npos) {
+            std::string city = line.substr(0, pos);
+            for (size_t i = 0; i < city.length(); i++) {
+                if (isalpha(city[i]) == false && city[i] != ' ' && city[i] != '\'') {
+                    // if the character is not a letter, space or apostrophe, remove it
+                    city.erase(i,1);
+                    i--;
+                }
+            }
+            data.push_back(std::make_pair(city, stoi(line.substr(pos + 1))));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Prints the throughput of a finished benchmark in the desired format.
+ * @param label The name of the benchmark.
+ * @param operations The number of operations performed.
+ * @param start The start time of the benchmark.
+ * @param checksum A value accumulated from the results so the work cannot be optimized away.
+ */
+void report(const std::string &label, long long operations, std::chrono::high_resolution_clock::time_point start, long long checksum) {
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start); // in nanoseconds
+    double perSecond = operations * 1e9 / std::max<long long>(1, duration.count());
+    std::cout << label << ": " << duration.count() << " ns, " << static_cast<long long>(perSecond) << " ops/s (checksum " << checksum << ")" << std::endl;
+}
+
+/**
+ * @brief Gets the number of heap bytes currently allocated by the program, glibc only.
+ * @return The allocated bytes.
+ */
+long long heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd; // small blocks + mmap'ed blocks
+}
+
+/**
+ * @brief Checks that the versions of a PersistentRedBlackTree are kept unchanged by later inserts and deletes.
+ *
+ * A version is kept after every eighth of the rows is inserted, then every other row is deleted from the last
+ * version. Every kept version must still hold its own rows in order, within the Red-Black height bound.
+ *
+ * @param data The (city, population) pairs to insert.
+ * @return True if every version is intact, otherwise false.
+ */
+bool checkPersistentVersions(const std::vector<std::pair<std::string, int>> &data) {
+    int dataLength = data.size();
+    int step = std::max(1, dataLength / 8);
+    PersistentRedBlackTree tree;
+    std::vector<PersistentRedBlackTree> versions(1, tree); // versions[k] holds the first k * step rows, the last one all rows
+    std::vector<int> expectedNodes(1, 0);
+    for (int i = 0; i < dataLength; i++) {
+        tree = tree.insert(data[i].first, data[i].second);
+        if ((i + 1) % step == 0 || i + 1 == dataLength) {
+            versions.push_back(tree);
+            expectedNodes.push_back(i + 1);
+        }
+    }
+    PersistentRedBlackTree thinned = tree;
+    int deleted = 0;
+    for (int i = 0; i < dataLength; i += 2) {
+        if (thinned.searchTree(data[i].second) != nullptr) {
+            thinned = thinned.deleteNode(data[i].second);
+            deleted++;
+        }
+    }
+    versions.push_back(thinned);
+    expectedNodes.push_back(dataLength - deleted);
+
+    for (size_t k = 0; k < versions.size(); k++) {
+        int totalNodes = versions[k].getTotalNodes();
+        std::vector<std::pair<std::string, int>> ordered(totalNodes);
+        versions[k].inorder(ordered.data(), 0);
+        bool sorted = std::is_sorted(ordered.begin(), ordered.end(), [](const std::pair<std::string, int> &a, const std::pair<std::string, int> &b) {
+            return a.second < b.second;
+        });
+        if (totalNodes != expectedNodes[k] || !sorted || versions[k].getHeight() + 1 > 2 * std::log2(totalNodes + 1)) {
+            std::cerr << "Persistent RBT version " << k << " changed: " << totalNodes << " nodes, expected " << expectedNodes[k] << std::endl;
+            return false;
+        }
+    }
+    std::cout << "Persistent RBT: " << versions.size() << " versions intact after " << deleted << " deletes" << std::endl;
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: " << argv[0] << " <input_filename> [query_count]" << std::endl;
+        return 1;
+    }
+    int queryCount = argc == 3 ? std::stoi(argv[2]) : 1000000;
+
+    std::vector<std::pair<std::string, int>> data;
+    if (!readPopulation(argv[1], data) || data.empty()) {
+        return 1;
+    }
+    int dataLength = data.size();
+
+    long long heapBefore = heapInUse();
+    RedBlackTree rbTree;
+    for (int i = 0; i < dataLength; i++) {
+        rbTree.insert(data[i].first, data[i].second);
+    }
+    long long rbtBytes = heapInUse() - heapBefore;
+
+    heapBefore = heapInUse();
+    CompactRedBlackTree compactTree;
+    compactTree.reserve(dataLength);
+    for (int i = 0; i < dataLength; i++) {
+        compactTree.insert(data[i].first, data[i].second);
+    }
+    long long compactBytes = heapInUse() - heapBefore;
+    std::vector<std::pair<std::string, int>> orderedData(dataLength);
+    rbTree.inorder(orderedData.data(), 0);
+    EytzingerIndex index(orderedData.data(), dataLength);
+
+    // queries are populations drawn uniformly from the file, so every lookup is a hit
+    std::mt19937 generator(335);
+    std::uniform_int_distribution<int> pick(0, dataLength - 1);
+    std::vector<int> queries(queryCount);
+    for (int i = 0; i < queryCount; i++) {
+        queries[i] = data[pick(generator)].second;
+    }
+
+    std::cout << "Rows: " << dataLength << ", queries: " << queryCount << std::endl;
+    std::cout << "RBT: " << sizeof(RBT::Node) << " bytes per node struct, " << rbtBytes / dataLength << " heap bytes per node" << std::endl;
+    std::cout << "Compact RBT: " << sizeof(CRBT::Node) << " bytes per node struct, " << compactBytes / dataLength << " heap bytes per node (names interned)" << std::endl;
+
+    long long checksum = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queryCount; i++) {
+        checksum += rbTree.searchTree(queries[i])->data;
+    }
+    report("RBT searchTree", queryCount, start, checksum);
+
+    checksum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queryCount; i++) {
+        checksum += compactTree.getData(compactTree.searchTree(queries[i]));
+    }
+    report("Compact RBT searchTree", queryCount, start, checksum);
+
+    if (!checkPersistentVersions(data)) {
+        return 1;
+    }
+    PersistentRedBlackTree persistentTree;
+    for (int i = 0; i < dataLength; i++) {
+        persistentTree = persistentTree.insert(data[i].first, data[i].second);
+    }
+    checksum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queryCount; i++) {
+        checksum += persistentTree.searchTree(queries[i])->data;
+    }
+    report("Persistent RBT searchTree", queryCount, start, checksum);
+
+    std::vector<RBT::Node*> found(queryCount);
+    for (size_t groupSize = 1; groupSize <= 64; groupSize *= 2) {
+        checksum = 0;
+        start = std::chrono::high_resolution_clock::now();
+        rbTree.searchBatch(queries.data(), queryCount, found.data(), groupSize);
+        for (int i = 0; i < queryCount; i++) {
+            checksum += found[i]->data;
+        }
+        report("RBT searchBatch (group " + std::to_string(groupSize) + ")", queryCount, start, checksum);
+    }
+
+    checksum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queryCount; i++) {
+        checksum += index.getData(index.searchTree(queries[i]));
+    }
+    report("Eytzinger searchTree", queryCount, start, checksum);
+
+    // snapshot round trip: loading maps the file instead of parsing the CSV and inserting every row
+    writeSnapshot(rbTree, "benchmark.snapshot");
+    RedBlackTreeSnapshot snapshot;
+    start = std::chrono::high_resolution_clock::now();
+    snapshot.load("benchmark.snapshot");
+    report("Snapshot load", 1, start, snapshot.getTotalNodes());
+
+    checksum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queryCount; i++) {
+        checksum += snapshot.getData(snapshot.searchTree(queries[i]));
+    }
+    report("Snapshot searchTree", queryCount, start, checksum);
+
+    checksum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queryCount; i++) {
+        RBT::Node *node = rbTree.searchTree(queries[i]);
+        RBT::Node *next = rbTree.successor(node);
+        RBT::Node *previous = rbTree.predecessor(node);
+        checksum += (next ? next->data : 0) - (previous ? previous->data : 0);
+    }
+    report("RBT search + successor + predecessor", queryCount, start, checksum);
+
+    checksum = 0;
+    start = std::chrono::high_resolution_clock::now();
+    for (int i = 0; i < queryCount; i++) {
+        int position = index.searchTree(queries[i]);
+        int next = index.successor(position);
+        int previous = index.predecessor(position);
+        checksum += (next != -1 ? index.getData(next) : 0) - (previous != -1 ? index.getData(previous) : 0);
+    }
+    report("Eytzinger search + successor + predecessor", queryCount, start, checksum);
+
+    // mixed workload: 90% searchTree + successor, 10% writes alternating insert and delete of the thread's own keys
+    ConcurrentRedBlackTree sharedTree;
+    for (int i = 0; i < dataLength; i++) {
+        sharedTree.insert(data[i].first, data[i].second);
+    }
+    for (int threadCount = 1; threadCount <= 8; threadCount *= 2) {
+        std::vector<long long> sums(threadCount, 0);
+        std::vector<std::thread> workers;
+        start = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < threadCount; t++) {
+            workers.emplace_back([&, t]() {
+                std::mt19937 threadGenerator(335 + t);
+                std::vector<int> ownKeys; // keys inserted by this thread, deleted in FIFO order
+                size_t nextToDelete = 0;
+                std::pair<std::string, int> result;
+                for (int i = t; i < queryCount; i += threadCount) {
+                    if (threadGenerator() % 10 == 0) {
+                        if (ownKeys.size() > nextToDelete && threadGenerator() % 2 == 0) {
+                            sharedTree.deleteNode(ownKeys[nextToDelete++]);
+                        } else {
+                            ownKeys.push_back(-1 - static_cast<int>(threadGenerator() % 1000000000)); // negative keys never collide with the file
+                            sharedTree.insert("Writer", ownKeys.back());
+                        }
+                    } else if (sharedTree.successor(queries[i], result)) {
+                        sums[t] += result.second;
+                    }
+                }
+            });
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+        checksum = 0;
+        for (long long sum : sums) {
+            checksum += sum;
+        }
+        report("Concurrent RBT 90/10 read/write (" + std::to_string(threadCount) + " threads)", queryCount, start, checksum);
+    }
+
+    // reader scaling: the readers share the queries while one writer keeps inserting and deleting its own keys
+    for (int threadCount = 1; threadCount <= 8; threadCount *= 2) {
+        std::vector<long long> sums(threadCount, 0);
+        std::vector<std::thread> readers;
+        std::atomic<bool> done{false};
+        std::thread writer([&]() {
+            for (int key = -1; !done.load(); key--) {
+                sharedTree.insert("Writer", key);
+                sharedTree.deleteNode(key);
+            }
+        });
+        start = std::chrono::high_resolution_clock::now();
+        for (int t = 0; t < threadCount; t++) {
+            readers.emplace_back([&, t]() {
+                std::pair<std::string, int> result;
+                for (int i = t; i < queryCount; i += threadCount) {
+                    if (sharedTree.successor(queries[i], result)) {
+                        sums[t] += result.second;
+                    }
+                }
+            });
+        }
+        for (std::thread &reader : readers) {
+            reader.join();
+        }
+        checksum = 0;
+        for (long long sum : sums) {
+            checksum += sum;
+        }
+        report("Concurrent RBT readers + 1 writer (" + std::to_string(threadCount) + " readers)", queryCount, start, checksum);
+        done.store(true);
+        writer.join();
+    }
+
+    // merging two regional indexes: even rows form one tree and odd rows the other
+    for (int threadDepth = -1; threadDepth <= 3; threadDepth++) {
+        RedBlackTree merged, region;
+        for (int i = 0; i < dataLength; i++) {
+            (i % 2 == 0 ? merged : region).insert(data[i].first, data[i].second);
+        }
+        std::vector<std::pair<std::string, int>> regionData(region.getTotalNodes());
+        region.inorder(regionData.data(), 0);
+        start = std::chrono::high_resolution_clock::now();
+        if (threadDepth < 0) { // the old way, inorder dump and insert every element
+            for (const std::pair<std::string, int> &row : regionData) {
+                merged.insert(row.first, row.second);
+            }
+        } else {
+            merged.unionWith(region, threadDepth);
+        }
+        std::string label = threadDepth < 0 ? "RBT merge by insert" : "RBT unionWith (" + std::to_string(1 << threadDepth) + " threads)";
+        report(label, regionData.size(), start, merged.getTotalNodes());
+    }
+
+    return 0;
+}
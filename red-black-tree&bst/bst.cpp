@@ -9,6 +9,7 @@
 */
 
 #include <iostream>
+#include <thread>
 
 /**
  * @brief Node struct to hold attributes of each node inside a namespace for the Binary Search Tree.
@@ -31,74 +32,156 @@ private:
   BST::Node *root; // Pointer to the root node of the tree
 
   /**
-   * @brief Helper function to recursively delete nodes starting from the given node.
-   * @param node The current node being deleted.
+   * @brief Helper function to iteratively delete nodes starting from the given node.
+   *
+   * Nodes are deleted in postorder by following parent pointers, so no stack is used and a degenerate
+   * tree of any height can be freed.
+   *
+   * @param node The root of the subtree being deleted.
    */
   void destroyTree(BST::Node* node) {
-    if (node != nullptr) {
-      destroyTree(node->left);  // Recursively delete left subtree
-      destroyTree(node->right); // Recursively delete right subtree
-      delete node;              // Delete the current node
-      node = nullptr;           // Set the current node to null to avoid dangling pointer
+    if (node == nullptr) {
+      return;
+    }
+    BST::Node* stop = node->parent; // Parent of the subtree, the walk ends when it is reached
+    BST::Node* current = findFirstLeaf(node);
+    while (current != nullptr) {
+      BST::Node* parent = current->parent;
+      BST::Node* next;
+      if (parent == stop) {
+        next = nullptr;                         // The subtree root is deleted last
+      } else if (current == parent->left && parent->right != nullptr) {
+        next = findFirstLeaf(parent->right);    // Delete the right subtree before the parent
+      } else {
+        next = parent;
+      }
+      delete current; // Delete the current node, its children are already deleted
+      current = next;
     }
   }
 
   /**
-   * @brief Helper function to traverse the tree in preorder and store the data in the given array.
-   * @param node The current node being traversed.
+   * @brief Helper function to traverse the tree in preorder iteratively and store the data in the given array.
+   * @param node The root of the subtree being traversed.
    * @param orderedData The array to store the data in.
    * @param index The index of the array to store the data in.
    */
   void preorderHelper(BST::Node *node, std::pair<std::string, int> orderedData[], int &index) {
-    if (node != nullptr) {
-      orderedData[index++] = std::make_pair(node->name, node->data);
-      preorderHelper(node->left, orderedData, index);
-      preorderHelper(node->right, orderedData, index);
+    BST::Node *stop = node != nullptr ? node->parent : nullptr;
+    BST::Node *current = node;
+    while (current != nullptr) {
+      orderedData[index++] = std::make_pair(current->name, current->data);
+      if (current->left != nullptr) {
+        current = current->left;
+      } else if (current->right != nullptr) {
+        current = current->right;
+      } else { // Climb until an ancestor has a right subtree that is not visited yet
+        while (current->parent != stop && (current == current->parent->right || current->parent->right == nullptr)) {
+          current = current->parent;
+        }
+        current = current->parent != stop ? current->parent->right : nullptr;
+      }
     }
   }
 
   /**
-   * @brief Helper function to traverse the tree in inorder and store the data in the given array.
-   * @param node The current node being traversed.
+   * @brief Helper function to traverse the tree in inorder iteratively and store the data in the given array.
+   * @param node The root of the subtree being traversed.
    * @param orderedData The array to store the data in.
    * @param index The index of the array to store the data in.
    */
   void inorderHelper(BST::Node *node, std::pair<std::string, int> orderedData[], int &index) {
-    if (node != nullptr) {
-      inorderHelper(node->left, orderedData, index);
-      orderedData[index++] = std::make_pair(node->name, node->data);
-      inorderHelper(node->right, orderedData, index);
+    if (node == nullptr) {
+      return;
+    }
+    BST::Node *stop = node->parent;
+    BST::Node *current = findMin(node);
+    while (current != nullptr) {
+      orderedData[index++] = std::make_pair(current->name, current->data);
+      if (current->right != nullptr) {
+        current = findMin(current->right);
+      } else { // Climb until coming up from a left child
+        while (current->parent != stop && current == current->parent->right) {
+          current = current->parent;
+        }
+        current = current->parent != stop ? current->parent : nullptr;
+      }
     }
   }
 
   /**
-   * @brief Helper function to traverse the tree in postorder and store the data in the given array.
-   * @param node The current node being traversed.
+   * @brief Helper function to traverse the tree in postorder iteratively and store the data in the given array.
+   * @param node The root of the subtree being traversed.
    * @param orderedData The array to store the data in.
    * @param index The index of the array to store the data in.
    */
   void postorderHelper(BST::Node *node, std::pair<std::string, int> orderedData[], int &index) {
-    if (node != nullptr) {
-      postorderHelper(node->left, orderedData, index);
-      postorderHelper(node->right, orderedData, index);
-      orderedData[index++] = std::make_pair(node->name, node->data);
+    if (node == nullptr) {
+      return;
+    }
+    BST::Node *stop = node->parent;
+    BST::Node *current = findFirstLeaf(node);
+    while (current != nullptr) {
+      orderedData[index++] = std::make_pair(current->name, current->data);
+      BST::Node *parent = current->parent;
+      if (parent == stop) {
+        current = nullptr;
+      } else if (current == parent->left && parent->right != nullptr) {
+        current = findFirstLeaf(parent->right);
+      } else {
+        current = parent;
+      }
     }
   }
 
+  /**
+   * @brief Helper function to find the first node of the subtree in postorder, the leaf reached by preferring left children.
+   * @param node The root of the subtree.
+   * @return The first leaf of the subtree.
+   */
+  BST::Node *findFirstLeaf(BST::Node *node) {
+    while (node->left != nullptr || node->right != nullptr) {
+      node = node->left != nullptr ? node->left : node->right;
+    }
+    return node;
+  }
+
   /**
    * @brief Helper function to get the height of the tree.
-   * @param node The current node being traversed.
+   *
+   * The subtree is walked iteratively by following parent pointers: a node entered from its parent goes one level
+   * deeper, and the previously visited node tells which child to visit next, so only O(1) extra space is used.
+   *
+   * @param node The root of the subtree being traversed.
    * @return The total count of nodes in tree. To get the height, subtract 1 from the result. 
    */
   int getHeightHelper(BST::Node *node) {
-    if (node == nullptr) {  // Base case: reached a null node
+    if (node == nullptr) { // Base case: empty tree
       return 0;
     }
-
-    int leftHeight = getHeightHelper(node->left);
-    int rightHeight = getHeightHelper(node->right);
-
-    return 1 + std::max(leftHeight, rightHeight); // Add 1 for the current node
+    BST::Node *stop = node->parent;
+    BST::Node *previous = stop;
+    BST::Node *current = node;
+    int depth = 0;
+    int height = 0;
+    while (current != stop) {
+      BST::Node *next;
+      if (previous == current->parent) { // Entered from the parent
+        depth++;
+        height = std::max(height, depth);
+        next = current->left != nullptr ? current->left : (current->right != nullptr ? current->right : current->parent);
+      } else if (previous == current->left) { // Came back from the left child
+        next = current->right != nullptr ? current->right : current->parent;
+      } else { // Came back from the right child
+        next = current->parent;
+      }
+      if (next == current->parent) {
+        depth--;
+      }
+      previous = current;
+      current = next;
+    }
+    return height;
   }
 
   /**
@@ -132,9 +215,23 @@ private:
    */
   int countNodes(BST::Node *node) {
     if (node == nullptr) {
-      return 0; // Base case: reached a null node
+      return 0; // Base case: empty tree
+    }
+    int count = 0;
+    BST::Node *stop = node->parent;
+    BST::Node *current = findMin(node);
+    while (current != nullptr) { // Same inorder walk as inorderHelper
+      count++;
+      if (current->right != nullptr) {
+        current = findMin(current->right);
+      } else {
+        while (current->parent != stop && current == current->parent->right) {
+          current = current->parent;
+        }
+        current = current->parent != stop ? current->parent : nullptr;
+      }
     }
-    return 1 + countNodes(node->left) + countNodes(node->right); // Add 1 for the current node
+    return count;
   }
 
   /**
@@ -156,6 +253,38 @@ private:
     }
   }
 
+  /**
+   * @brief Helper function to build a balanced subtree from the sorted range [head, tail] of the given array.
+   * @param sortedData The array sorted in ascending order of population.
+   * @param head Index of the first element of the range.
+   * @param tail Index of the last element of the range.
+   * @param parent The parent of the subtree to be built.
+   * @param threadDepth The number of levels below this one whose left subtrees are built on separate threads.
+   * @return The root of the built subtree, or null if the range is empty.
+   */
+  BST::Node *buildHelper(const std::pair<std::string, int> sortedData[], int head, int tail, BST::Node *parent, int threadDepth) {
+    if (head > tail) {
+      return nullptr; // Base case: empty range
+    }
+
+    int mid = head + (tail - head) / 2; // Middle element is the root of the subtree
+    BST::Node *node = new BST::Node;
+    node->name = sortedData[mid].first;
+    node->data = sortedData[mid].second;
+    node->parent = parent;
+    if (threadDepth > 0) { // Build the left subtree on a separate thread, the ranges are disjoint so no locking is needed
+      std::thread leftBuilder([&]() {
+        node->left = buildHelper(sortedData, head, mid - 1, node, threadDepth - 1);
+      });
+      node->right = buildHelper(sortedData, mid + 1, tail, node, threadDepth - 1);
+      leftBuilder.join();
+    } else {
+      node->left = buildHelper(sortedData, head, mid - 1, node, 0);
+      node->right = buildHelper(sortedData, mid + 1, tail, node, 0);
+    }
+    return node;
+  }
+
 public:
   /**
    * @brief Constructor to initialize the root node to null.
@@ -219,6 +348,62 @@ public:
     return current;
   }
 
+  /**
+  * @brief Function to search the tree for the city with the given population and name.
+  *
+  * Cities with equal populations are kept in insertion order, so the search first descends to the
+  * leftmost node with the given population and then walks the successors until the name matches.
+  *
+  * @param value The population to search for.
+  * @param name The city name to search for.
+  * @return The node with the given population and name, if found. Otherwise, returns null.
+  */
+  BST::Node* searchTree(int value, const std::string& name) {
+    BST::Node* current = root;
+    BST::Node* first = nullptr; // Leftmost node with the given value seen so far
+    while (current != nullptr) {
+      if (value <= current->data) {
+        if (value == current->data) {
+          first = current;
+        }
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+
+    while (first != nullptr && first->data == value) {
+      if (first->name == name) {
+        return first;
+      }
+      first = successor(first);
+    }
+    return nullptr;
+  }
+
+  /**
+  * @brief Function to find the first node whose value is not less than the given value.
+  *
+  * Together with successor this answers range queries: start from lowerBound(low) and walk the
+  * successors while the value does not exceed the upper end of the range.
+  *
+  * @param value The lower end of the range.
+  * @return The leftmost node with a value greater than or equal to the given value, or nullptr if there is none.
+  */
+  BST::Node* lowerBound(int value) {
+    BST::Node* current = root;
+    BST::Node* candidate = nullptr;
+    while (current != nullptr) {
+      if (current->data >= value) {
+        candidate = current;
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    return candidate;
+  }
+
   /**
   * @brief Find the successor of a node in a Binary Search Tree (BST).
   *
@@ -273,7 +458,7 @@ public:
       BST::Node *predecessor = nullptr;
 
       while (node->parent != nullptr) {
-          if (node->data > node->parent->data) {
+          if (node == node->parent->right) {
               predecessor = node->parent;
               break;
           }
@@ -288,12 +473,14 @@ public:
   *
   * Inserts a new node with the specified name and value into the BST. The new node is placed in the
   * appropriate position based on the comparison of values. If the value is less than the current
-  * node's value, it is placed in the left subtree; otherwise, it is placed in the right subtree.
+  * node's value, it is placed in the left subtree; otherwise, it is placed in the right subtree,
+  * so equal populations always stay in insertion order.
   *
   * @param name The name associated with the new node.
   * @param value The value to be inserted into the BST.
+  * @return The inserted node, which can later be passed to deleteNode.
   */
-  void insert(const std::string& name, int value) {
+  BST::Node* insert(const std::string& name, int value) {
     BST::Node* newNode = new BST::Node;
     newNode->data = value;
     newNode->name = name;
@@ -323,24 +510,39 @@ public:
     } else {
       parent->right = newNode;
     }
+    return newNode;
   }
 
   /**
-  * @brief Deletes a node with the given value from the Binary Search Tree (BST).
+  * @brief Builds the Binary Search Tree (BST) from an array that is already sorted by population.
+  *
+  * Any existing nodes are freed first. Inserting sorted input one by one degenerates the BST into a
+  * long chain, whereas this function links each middle element as the subtree root, so the tree is
+  * built in O(n) time with the minimum possible height floor(log2(n)).
+  *
+  * @param sortedData The array sorted in ascending order of population, e.g. the output of QuickSort or HeapSort.
+  * @param length The number of elements in the array.
+  * @param threadDepth The number of top levels whose subtrees are built in parallel, 2^threadDepth threads are used. 0 builds serially.
+  */
+  void buildFromSorted(const std::pair<std::string, int> sortedData[], int length, int threadDepth = 0) {
+    destroyTree(root);
+    root = buildHelper(sortedData, 0, length - 1, nullptr, threadDepth);
+  }
+
+  /**
+  * @brief Deletes the given node from the Binary Search Tree (BST).
   *
-  * Deletes the node with the specified value from the BST. The deletion operation takes into account
+  * Deletes the given node from the BST without searching for it again. The deletion operation takes into account
   * three cases based on the number of children the node to be deleted has:
   * - Case 1: Node has 0 children (leaf node)
   * - Case 2: Node has 1 child
   * - Case 3: Node has 2 children
   *
-  * @param value The value of the node to be deleted.
+  * @param nodeToDelete The node to be deleted, e.g. the result of insert or searchTree. It is freed by this call.
   */
-  void deleteNode(int value) {
-    BST::Node* nodeToDelete = searchTree(value); // First find the node to be deleted
-
+  void deleteNode(BST::Node* nodeToDelete) {
     if (nodeToDelete == nullptr) {
-      return; // Node with the given value not found
+      return; // Nothing to delete
     }
 
     if (nodeToDelete->left == nullptr) {                  // cases when current node has 0 child, it simply satisfy the first if then replaced with nullptr(nodeToDelete->right)
@@ -364,6 +566,26 @@ public:
     delete nodeToDelete; // Delete the node
   }
 
+  /**
+  * @brief Deletes a node with the given value from the Binary Search Tree (BST).
+  *
+  * If several cities share the population, the one found first by searchTree is deleted.
+  *
+  * @param value The value of the node to be deleted.
+  */
+  void deleteNode(int value) {
+    deleteNode(searchTree(value)); // First find the node to be deleted
+  }
+
+  /**
+  * @brief Deletes the city with the given population and name from the Binary Search Tree (BST).
+  * @param value The value of the node to be deleted.
+  * @param name The city name of the node to be deleted.
+  */
+  void deleteNode(int value, const std::string& name) {
+    deleteNode(searchTree(value, name));
+  }
+
   /**
    * @brief Function to get the height of the tree.
    * @return The height of the tree.
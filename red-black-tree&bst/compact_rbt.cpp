@@ -0,0 +1,548 @@
+// Implementing a compact, arena based Red-Black Tree in C++
+// rbt.cpp must be included before this file
+
+/**
+  BLG335E - Analysis of Algorithms I - Project 3
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <unordered_map>
+
+/**
+ * @brief Node struct to hold attributes of each node inside a namespace for the compact Red-Black Tree.
+ *
+ * Nodes live in one array and refer to each other by 32-bit index, the city name is a 32-bit id into
+ * a shared string pool, and the color is packed into the lowest bit of the parent index, so a node
+ * takes 20 bytes instead of the 72 bytes (plus allocator overhead) of RBT::Node.
+ */
+namespace CRBT {
+  struct Node {
+    int data;
+    uint32_t name;         // Id of the city name in the string pool
+    uint32_t left;
+    uint32_t right;
+    uint32_t parentColor;  // (parent index << 1) | color
+  };
+
+  const uint32_t NIL = 0; // Index of the black sentinel node that stands for null
+}
+
+/**
+ * @brief A pool that stores every distinct city name once and hands out 32-bit ids for them.
+ */
+class StringPool {
+private:
+  std::unordered_map<std::string, uint32_t> ids; // Name to id
+  std::vector<const std::string *> strings;      // Id to name, points into the keys of ids which never move
+
+public:
+  /**
+   * @brief Returns the id of the given name, adding the name to the pool if it is new.
+   * @param name The name to intern.
+   * @return The id of the name.
+   */
+  uint32_t intern(const std::string &name) {
+    auto inserted = ids.emplace(name, static_cast<uint32_t>(strings.size()));
+    if (inserted.second) {
+      strings.push_back(&inserted.first->first);
+    }
+    return inserted.first->second;
+  }
+
+  /**
+   * @brief Gets the name with the given id.
+   * @param id The id of the name.
+   * @return The name.
+   */
+  const std::string &get(uint32_t id) const {
+    return *strings[id];
+  }
+};
+
+/**
+ * @brief A class representing a Red-Black Tree stored in a node arena with packed colors and interned names.
+ *
+ * The algorithms are those of RedBlackTree, written with a sentinel node at index 0 (CRBT::NIL) in place of
+ * null. Nodes are addressed by index; CRBT::NIL is returned where RedBlackTree returns null. Slots of
+ * deleted nodes are reused by later inserts.
+ */
+class CompactRedBlackTree {
+private:
+  std::vector<CRBT::Node> nodes;   // Node arena, nodes[CRBT::NIL] is the sentinel
+  std::vector<uint32_t> freeSlots; // Slots of deleted nodes
+  uint32_t root;                   // Index of the root of the tree
+  StringPool names;                // Interned city names
+
+  /**
+   * @brief Helper functions to read and write the parent index and the color packed into parentColor.
+   * @param x The index of the node.
+   */
+  uint32_t parentOf(uint32_t x) const { return nodes[x].parentColor >> 1; }
+  int colorOf(uint32_t x) const { return nodes[x].parentColor & 1; }
+  void setParent(uint32_t x, uint32_t parent) { nodes[x].parentColor = (parent << 1) | (nodes[x].parentColor & 1); }
+  void setColor(uint32_t x, int color) { nodes[x].parentColor = (nodes[x].parentColor & ~1u) | color; }
+
+  /**
+   * @brief Performs a left rotation around the given node.
+   * @param x The node around which the left rotation is performed.
+   */
+  void leftRotate(uint32_t x) {
+    uint32_t y = nodes[x].right;
+    nodes[x].right = nodes[y].left;
+    if (nodes[y].left != CRBT::NIL)
+      setParent(nodes[y].left, x);
+
+    setParent(y, parentOf(x));
+
+    if (parentOf(x) == CRBT::NIL)
+      root = y;
+    else if (x == nodes[parentOf(x)].left)
+      nodes[parentOf(x)].left = y;
+    else
+      nodes[parentOf(x)].right = y;
+
+    nodes[y].left = x;
+    setParent(x, y);
+  }
+
+  /**
+   * @brief Performs a right rotation around the given node.
+   * @param y The node around which the right rotation is performed.
+   */
+  void rightRotate(uint32_t y) {
+    uint32_t x = nodes[y].left;
+    nodes[y].left = nodes[x].right;
+    if (nodes[x].right != CRBT::NIL)
+      setParent(nodes[x].right, y);
+
+    setParent(x, parentOf(y));
+
+    if (parentOf(y) == CRBT::NIL)
+      root = x;
+    else if (y == nodes[parentOf(y)].left)
+      nodes[parentOf(y)].left = x;
+    else
+      nodes[parentOf(y)].right = x;
+
+    nodes[x].right = y;
+    setParent(y, x);
+  }
+
+  /**
+   * @brief Helper function to replace the subtree rooted at node u with the subtree rooted at node v.
+   * @param u The node to be replaced.
+   * @param v The node to replace the node u, may be the sentinel.
+   */
+  void transplant(uint32_t u, uint32_t v) {
+    if (parentOf(u) == CRBT::NIL) {
+      root = v;
+    } else if (u == nodes[parentOf(u)].left) {
+      nodes[parentOf(u)].left = v;
+    } else {
+      nodes[parentOf(u)].right = v;
+    }
+    setParent(v, parentOf(u)); // The sentinel's parent is set too, deleteFixup relies on it
+  }
+
+  /**
+   * @brief Helper function to find the minimum value in the tree rooted with given node.
+   * @param node The initial root of the subtree.
+   * @return The node with the minimum value in the tree rooted with given node.
+   */
+  uint32_t findMin(uint32_t node) const {
+    while (nodes[node].left != CRBT::NIL) {
+      node = nodes[node].left;
+    }
+    return node;
+  }
+
+  /**
+   * @brief Helper function to find the maximum value in the tree rooted with given node.
+   * @param node The initial root of the subtree.
+   * @return The node with the maximum value in the tree rooted with given node.
+   */
+  uint32_t findMax(uint32_t node) const {
+    while (nodes[node].right != CRBT::NIL) {
+      node = nodes[node].right;
+    }
+    return node;
+  }
+
+  /**
+   * @brief Helper function to get the height of the tree.
+   * @param node The current node being traversed.
+   * @return The total count of nodes from the given node to the deepest leaf.
+   */
+  int getHeightHelper(uint32_t node) const {
+    if (node == CRBT::NIL) { // Base case: reached a null node
+      return 0;
+    }
+    return 1 + std::max(getHeightHelper(nodes[node].left), getHeightHelper(nodes[node].right));
+  }
+
+  /**
+   * @brief Helper function to traverse the tree in inorder and store the data in the given array.
+   * @param node The current node being traversed.
+   * @param orderedData The array to store the data in.
+   * @param index The index of the array to store the data in.
+   */
+  void inorderHelper(uint32_t node, std::pair<std::string, int> orderedData[], int &index) const {
+    if (node != CRBT::NIL) {
+      inorderHelper(nodes[node].left, orderedData, index);
+      orderedData[index++] = std::make_pair(names.get(nodes[node].name), nodes[node].data);
+      inorderHelper(nodes[node].right, orderedData, index);
+    }
+  }
+
+  /**
+  * @brief Performs fixup operations after node insertion, same cases as RedBlackTree::insertFixup.
+  * @param z The newly inserted node that may violate the Red-Black Tree properties.
+  */
+  void insertFixup(uint32_t z) {
+    while (colorOf(parentOf(z)) == RED) {
+      uint32_t parent = parentOf(z);
+      uint32_t grandparent = parentOf(parent);
+      if (parent == nodes[grandparent].left) {
+        uint32_t y = nodes[grandparent].right;
+        if (colorOf(y) == RED) {
+          setColor(parent, BLACK);         // Case 1
+          setColor(y, BLACK);              // Case 1
+          setColor(grandparent, RED);      // Case 1
+          z = grandparent;                 // Case 1
+        } else {
+          if (z == nodes[parent].right) {
+            z = parent;                    // Case 2
+            leftRotate(z);                 // Case 2
+          }
+          setColor(parentOf(z), BLACK);             // Case 3
+          setColor(parentOf(parentOf(z)), RED);     // Case 3
+          rightRotate(parentOf(parentOf(z)));       // Case 3
+        }
+      } else {
+        uint32_t y = nodes[grandparent].left;
+        if (colorOf(y) == RED) {
+          setColor(parent, BLACK);         // Case 4
+          setColor(y, BLACK);              // Case 4
+          setColor(grandparent, RED);      // Case 4
+          z = grandparent;                 // Case 4
+        } else {
+          if (z == nodes[parent].left) {
+            z = parent;                    // Case 5
+            rightRotate(z);                // Case 5
+          }
+          setColor(parentOf(z), BLACK);             // Case 6
+          setColor(parentOf(parentOf(z)), RED);     // Case 6
+          leftRotate(parentOf(parentOf(z)));        // Case 6
+        }
+      }
+    }
+    setColor(root, BLACK); // Ensure the root is black // Case 0
+  }
+
+  /**
+  * @brief Performs fixup operations after node deletion, same cases as RedBlackTree::deleteFixup.
+  * @param x The node that might violate the Red-Black Tree properties after deletion, may be the sentinel.
+  */
+  void deleteFixup(uint32_t x) {
+    while (x != root && colorOf(x) == BLACK) {
+      uint32_t parent = parentOf(x);
+      if (x == nodes[parent].left) {
+        uint32_t w = nodes[parent].right;
+        if (colorOf(w) == RED) {
+          setColor(w, BLACK);              // Case 1
+          setColor(parent, RED);           // Case 1
+          leftRotate(parent);              // Case 1
+          w = nodes[parent].right;         // Case 1
+        }
+        if (colorOf(nodes[w].left) == BLACK && colorOf(nodes[w].right) == BLACK) {
+          setColor(w, RED);                // Case 2
+          x = parent;                      // Case 2
+        } else {
+          if (colorOf(nodes[w].right) == BLACK) {
+            setColor(nodes[w].left, BLACK); // Case 3
+            setColor(w, RED);              // Case 3
+            rightRotate(w);                // Case 3
+            w = nodes[parent].right;       // Case 3
+          }
+          setColor(w, colorOf(parent));    // Case 4
+          setColor(parent, BLACK);         // Case 4
+          setColor(nodes[w].right, BLACK); // Case 4
+          leftRotate(parent);              // Case 4
+          x = root;                        // Case 4
+        }
+      } else { // Symmetric cases for right subtree
+        uint32_t w = nodes[parent].left;
+        if (colorOf(w) == RED) {
+          setColor(w, BLACK);              // Case 1
+          setColor(parent, RED);           // Case 1
+          rightRotate(parent);             // Case 1
+          w = nodes[parent].left;          // Case 1
+        }
+        if (colorOf(nodes[w].right) == BLACK && colorOf(nodes[w].left) == BLACK) {
+          setColor(w, RED);                // Case 2
+          x = parent;                      // Case 2
+        } else {
+          if (colorOf(nodes[w].left) == BLACK) {
+            setColor(nodes[w].right, BLACK); // Case 3
+            setColor(w, RED);              // Case 3
+            leftRotate(w);                 // Case 3
+            w = nodes[parent].left;        // Case 3
+          }
+          setColor(w, colorOf(parent));    // Case 4
+          setColor(parent, BLACK);         // Case 4
+          setColor(nodes[w].left, BLACK);  // Case 4
+          rightRotate(parent);             // Case 4
+          x = root;                        // Case 4
+        }
+      }
+    }
+    setColor(x, BLACK); // Ensure the root is black
+  }
+
+public:
+  /**
+   * @brief Constructor to create the sentinel node and initialize the root to it.
+   */
+  CompactRedBlackTree() {
+    nodes.push_back(CRBT::Node{0, 0, CRBT::NIL, CRBT::NIL, (CRBT::NIL << 1) | BLACK});
+    root = CRBT::NIL;
+  }
+
+  /**
+   * @brief Reserves arena space for the given number of nodes, so building a large tree does not reallocate.
+   * @param count The expected number of nodes.
+   */
+  void reserve(size_t count) {
+    nodes.reserve(count + 1);
+  }
+
+  /**
+  * @brief Inserts a node into the tree and performs fixup operations.
+  * @param name The name of the node to be inserted.
+  * @param data The data value associated with the node to be inserted.
+  * @return The index of the inserted node.
+  */
+  uint32_t insert(const std::string &name, int data) {
+    uint32_t z;
+    CRBT::Node node{data, names.intern(name), CRBT::NIL, CRBT::NIL, RED}; // New node is always red
+    if (!freeSlots.empty()) {
+      z = freeSlots.back();
+      freeSlots.pop_back();
+      nodes[z] = node;
+    } else {
+      z = nodes.size();
+      nodes.push_back(node);
+    }
+
+    uint32_t y = CRBT::NIL;
+    uint32_t x = root;
+
+    // Traverse the tree to find the appropriate position for the new node
+    while (x != CRBT::NIL) {
+      y = x;
+      x = data < nodes[x].data ? nodes[x].left : nodes[x].right; // Equal keys go right to keep insertion order
+    }
+
+    setParent(z, y);
+
+    // Update the parent's left or right pointer based on the comparison
+    if (y == CRBT::NIL)
+      root = z;
+    else if (data < nodes[y].data)
+      nodes[y].left = z;
+    else
+      nodes[y].right = z;
+
+    insertFixup(z); // Fixup the Red-Black Tree after insertion
+    return z;
+  }
+
+  /**
+  * @brief Deletes the given node from the tree, its slot is reused by a later insert.
+  * @param z The index of the node to be deleted.
+  */
+  void deleteNode(uint32_t z) {
+    if (z == CRBT::NIL) {
+      return; // Nothing to delete
+    }
+    uint32_t x;
+    uint32_t y = z;
+    int yOriginalColor = colorOf(y);
+
+    if (nodes[z].left == CRBT::NIL) {
+      x = nodes[z].right;
+      transplant(z, nodes[z].right);
+    } else if (nodes[z].right == CRBT::NIL) {
+      x = nodes[z].left;
+      transplant(z, nodes[z].left);
+    } else {
+      y = findMin(nodes[z].right); // Find the successor node (minimum value in the right subtree)
+      yOriginalColor = colorOf(y);
+      x = nodes[y].right;
+      if (parentOf(y) == z) {
+        setParent(x, y);
+      } else {
+        transplant(y, nodes[y].right);
+        nodes[y].right = nodes[z].right;
+        setParent(nodes[y].right, y);
+      }
+      transplant(z, y);
+      nodes[y].left = nodes[z].left;
+      setParent(nodes[y].left, y);
+      setColor(y, colorOf(z));
+    }
+
+    freeSlots.push_back(z);
+
+    if (yOriginalColor == BLACK) {
+      deleteFixup(x);
+    }
+  }
+
+  /**
+  * @brief Deletes a node with the given data from the tree.
+  * @param data The data value of the node to be deleted.
+  */
+  void deleteNode(int data) {
+    deleteNode(searchTree(data));
+  }
+
+  /**
+   * @brief Function to search the tree iteratively for a given value.
+   * @param value The value to search for.
+   * @return The index of the node with the given value, if found. Otherwise, returns CRBT::NIL.
+   */
+  uint32_t searchTree(int value) const {
+    uint32_t current = root;
+    while (current != CRBT::NIL && value != nodes[current].data) {
+      current = value < nodes[current].data ? nodes[current].left : nodes[current].right;
+    }
+    return current;
+  }
+
+  /**
+  * @brief Find the successor of a node.
+  * @param node The index of the node for which to find the successor.
+  * @return The index of the successor node, or CRBT::NIL if there is none.
+  */
+  uint32_t successor(uint32_t node) const {
+    if (node == CRBT::NIL) {
+      return CRBT::NIL;
+    }
+    if (nodes[node].right != CRBT::NIL) {
+      return findMin(nodes[node].right);
+    }
+    uint32_t ancestor = parentOf(node);
+    while (ancestor != CRBT::NIL && node == nodes[ancestor].right) {
+      node = ancestor;
+      ancestor = parentOf(ancestor);
+    }
+    return ancestor;
+  }
+
+  /**
+  * @brief Find the predecessor of a node.
+  * @param node The index of the node for which to find the predecessor.
+  * @return The index of the predecessor node, or CRBT::NIL if there is none.
+  */
+  uint32_t predecessor(uint32_t node) const {
+    if (node == CRBT::NIL) {
+      return CRBT::NIL;
+    }
+    if (nodes[node].left != CRBT::NIL) {
+      return findMax(nodes[node].left);
+    }
+    uint32_t ancestor = parentOf(node);
+    while (ancestor != CRBT::NIL && node == nodes[ancestor].left) {
+      node = ancestor;
+      ancestor = parentOf(ancestor);
+    }
+    return ancestor;
+  }
+
+  /**
+   * @brief Function to traverse the tree in inorder and store the data in the given array.
+   * @param orderedData The array to store the data in.
+   * @param startIndex The starting index of the array to store the data in.
+   */
+  void inorder(std::pair<std::string, int> orderedData[], int startIndex) const {
+    int index = startIndex;
+    inorderHelper(root, orderedData, index);
+  }
+
+  /**
+   * @brief Gets the population of the given node.
+   * @param node The index of the node.
+   * @return The population.
+   */
+  int getData(uint32_t node) const {
+    return nodes[node].data;
+  }
+
+  /**
+   * @brief Gets the city name of the given node.
+   * @param node The index of the node.
+   * @return The city name.
+   */
+  const std::string &getName(uint32_t node) const {
+    return names.get(nodes[node].name);
+  }
+
+  /**
+   * @brief Gets the color of the given node.
+   * @param node The index of the node.
+   * @return BLACK or RED.
+   */
+  int getColor(uint32_t node) const {
+    return colorOf(node);
+  }
+
+  /**
+   * @brief Gets the index of the root node, mainly for validating the tree.
+   * @return The root index, or CRBT::NIL if the tree is empty.
+   */
+  uint32_t getRoot() const {
+    return root;
+  }
+
+  /**
+   * @brief Gets the left child of the given node.
+   * @param node The index of the node.
+   * @return The index of the left child, or CRBT::NIL.
+   */
+  uint32_t getLeft(uint32_t node) const {
+    return nodes[node].left;
+  }
+
+  /**
+   * @brief Gets the right child of the given node.
+   * @param node The index of the node.
+   * @return The index of the right child, or CRBT::NIL.
+   */
+  uint32_t getRight(uint32_t node) const {
+    return nodes[node].right;
+  }
+
+  /**
+   * @brief Function to get the height of the tree.
+   * @return The height of the tree.
+   */
+  int getHeight() const {
+    return getHeightHelper(root) - 1; // (Count of nodes from top  to bottom) - 1 = height
+  }
+
+  /**
+  * @brief Gets the total number of nodes in the tree.
+  * @return The total number of nodes, or 0 if the tree is empty.
+  */
+  int getTotalNodes() const {
+    return nodes.size() - 1 - freeSlots.size();
+  }
+
+}; // End of CompactRedBlackTree class
@@ -0,0 +1,245 @@
+// Implementing a thread-safe Red-Black Tree with lock-free readers in C++
+// rbt.cpp and persistent_rbt.cpp must be included before this file
+
+/**
+  BLG335E - Analysis of Algorithms I - Project 3
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+#include <iostream>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <stdexcept>
+
+/**
+ * @brief Epoch and per-thread reader slots shared by every ConcurrentRedBlackTree, inside a namespace for the concurrent tree.
+ *
+ * A reader stores the global epoch in its slot before it loads the current version and clears the slot when it
+ * is done, so a writer knows which retired versions a reader may still be walking. The epoch is shared by all
+ * trees, so the epochs announced for one tree can be compared with the retirements of another.
+ */
+namespace RCU {
+  const int MAX_READERS = 128; // Readers alive at the same time
+  const unsigned long long IDLE = 0; // Slot value of a thread that is not reading, epochs start at 1
+
+  struct alignas(64) ReaderSlot { // One cache line per slot, so readers never write to a shared line
+    std::atomic<unsigned long long> epoch{IDLE};
+    std::atomic<bool> inUse{false}; // Owned by a thread that has read and not exited yet
+  };
+
+  ReaderSlot slots[MAX_READERS];            // Reader slots, claimed by the threads
+  std::atomic<unsigned long long> epoch{1}; // Advanced by every writer after it publishes
+
+  /**
+   * @brief Owns the slot of a thread, claimed on its first read and given back when the thread exits.
+   */
+  struct SlotGuard {
+    ReaderSlot *slot = nullptr;
+
+    ~SlotGuard() {
+      if (slot != nullptr) {
+        slot->epoch.store(IDLE);
+        slot->inUse.store(false); // Free for the next thread
+      }
+    }
+  };
+
+  /**
+   * @brief Gets the slot of the calling thread, claiming a free one on its first read.
+   * @return The slot of the calling thread.
+   */
+  inline ReaderSlot &threadSlot() {
+    thread_local SlotGuard guard;
+    if (guard.slot == nullptr) {
+      for (int i = 0; i < MAX_READERS && guard.slot == nullptr; i++) {
+        bool expected = false;
+        if (!slots[i].inUse.load() && slots[i].inUse.compare_exchange_strong(expected, true)) {
+          guard.slot = &slots[i];
+        }
+      }
+      if (guard.slot == nullptr) {
+        throw std::length_error("Too many reader threads for ConcurrentRedBlackTree");
+      }
+    }
+    return *guard.slot;
+  }
+}
+
+/**
+ * @brief A Red-Black Tree that can be read by many threads while another thread updates it.
+ *
+ * The tree is a PersistentRedBlackTree version behind an atomic pointer. Readers announce the current epoch,
+ * load the pointer and walk that version without taking any lock; nodes of a version are never modified, so
+ * a reader always sees a complete, balanced tree. Writers serialize on a mutex, build the next version by path
+ * copying, publish it with one atomic store and retire the old version. A retired version is freed only once
+ * no reader announced an epoch at or before its retirement, so readers never touch freed nodes.
+ * Node pointers are never handed out; the queries return a copy of the (city, population) pair instead.
+ */
+class ConcurrentRedBlackTree {
+private:
+  /**
+   * @brief A published version with the number of its nodes.
+   */
+  struct Version {
+    PersistentRedBlackTree tree;
+    int totalNodes;
+  };
+
+  std::atomic<const Version *> current; // The version new readers see
+  std::mutex writeLock;                 // Serializes writers
+  std::vector<std::pair<const Version *, unsigned long long>> retired; // Old versions and the epoch they were retired in
+
+  /**
+   * @brief Helper function to run a query on the current version without taking a lock.
+   * @param query The query, called with the version.
+   * @return The result of the query.
+   */
+  template <class Query> bool read(Query query) const {
+    RCU::ReaderSlot &slot = RCU::threadSlot();
+    slot.epoch.store(RCU::epoch.load()); // Announce before loading, see publish
+    bool found = query(*current.load());
+    slot.epoch.store(RCU::IDLE);
+    return found;
+  }
+
+  /**
+   * @brief Helper function to publish a new version and free the retired versions no reader can still hold.
+   *
+   * A reader that loaded the old version announced an epoch read before this store, so at most the epoch the
+   * old version is retired in. A version can be freed once every announced epoch is later than its own.
+   *
+   * @param next The new version.
+   */
+  void publish(const Version *next) {
+    const Version *old = current.exchange(next);
+    retired.push_back(std::make_pair(old, RCU::epoch.fetch_add(1)));
+
+    unsigned long long oldest = ~0ULL; // Oldest epoch a reader announced
+    for (int i = 0; i < RCU::MAX_READERS; i++) {
+      unsigned long long announced = RCU::slots[i].epoch.load();
+      if (announced != RCU::IDLE && announced < oldest) {
+        oldest = announced;
+      }
+    }
+    size_t kept = 0;
+    for (const std::pair<const Version *, unsigned long long> &version : retired) {
+      if (version.second < oldest) {
+        delete version.first; // Nodes still shared with newer versions survive by their reference counts
+      } else {
+        retired[kept++] = version;
+      }
+    }
+    retired.resize(kept);
+  }
+
+public:
+  /**
+   * @brief Constructor to create an empty tree.
+   */
+  ConcurrentRedBlackTree() : current(new Version{PersistentRedBlackTree(), 0}) {}
+
+  /**
+   * @brief Destructor, no reader or writer may be running.
+   */
+  ~ConcurrentRedBlackTree() {
+    for (const std::pair<const Version *, unsigned long long> &version : retired) {
+      delete version.first;
+    }
+    delete current.load();
+  }
+
+  ConcurrentRedBlackTree(const ConcurrentRedBlackTree &) = delete;
+  ConcurrentRedBlackTree &operator=(const ConcurrentRedBlackTree &) = delete;
+
+  /**
+   * @brief Inserts a city into the tree, readers keep reading the previous version until it is published.
+   * @param name The name of the city.
+   * @param data The population of the city.
+   */
+  void insert(const std::string &name, int data) {
+    std::lock_guard<std::mutex> guard(writeLock);
+    const Version *version = current.load();
+    publish(new Version{version->tree.insert(name, data), version->totalNodes + 1});
+  }
+
+  /**
+   * @brief Deletes a city with the given population, readers keep reading the previous version until it is published.
+   * @param data The population of the city to be deleted.
+   */
+  void deleteNode(int data) {
+    std::lock_guard<std::mutex> guard(writeLock);
+    const Version *version = current.load();
+    if (version->tree.searchTree(data) == nullptr) {
+      return; // Node with the given value not found
+    }
+    publish(new Version{version->tree.deleteNode(data), version->totalNodes - 1});
+  }
+
+  /**
+   * @brief Function to search the tree for a given value.
+   * @param value The value to search for.
+   * @param result The (city, population) pair of the found node.
+   * @return True if a node with the given value is found, otherwise false.
+   */
+  bool searchTree(int value, std::pair<std::string, int> &result) const {
+    return read([&](const Version &version) {
+      const PRBT::Node *node = version.tree.searchTree(value);
+      if (node == nullptr) {
+        return false;
+      }
+      result = std::make_pair(node->name, node->data);
+      return true;
+    });
+  }
+
+  /**
+   * @brief Find the successor of the node with the given value, the next larger population.
+   * @param value The value of the node whose successor is searched.
+   * @param result The (city, population) pair of the successor.
+   * @return True if both the node and its successor exist, otherwise false.
+   */
+  bool successor(int value, std::pair<std::string, int> &result) const {
+    return read([&](const Version &version) {
+      const PRBT::Node *node = version.tree.searchTree(value) ? version.tree.successor(value) : nullptr;
+      if (node == nullptr) {
+        return false;
+      }
+      result = std::make_pair(node->name, node->data);
+      return true;
+    });
+  }
+
+  /**
+   * @brief Find the predecessor of the node with the given value, the next smaller population.
+   * @param value The value of the node whose predecessor is searched.
+   * @param result The (city, population) pair of the predecessor.
+   * @return True if both the node and its predecessor exist, otherwise false.
+   */
+  bool predecessor(int value, std::pair<std::string, int> &result) const {
+    return read([&](const Version &version) {
+      const PRBT::Node *node = version.tree.searchTree(value) ? version.tree.predecessor(value) : nullptr;
+      if (node == nullptr) {
+        return false;
+      }
+      result = std::make_pair(node->name, node->data);
+      return true;
+    });
+  }
+
+  /**
+   * @brief Gets the total number of nodes in the tree.
+   * @return The total number of nodes.
+   */
+  int getTotalNodes() const {
+    int total = 0;
+    read([&](const Version &version) {
+      total = version.totalNodes;
+      return true;
+    });
+    return total;
+  }
+
+}; // End of ConcurrentRedBlackTree class
@@ -0,0 +1,156 @@
+// Implementing a static Eytzinger layout search index in C++
+
+/**
+  BLG335E - Analysis of Algorithms I - Project 3
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+/**
+ * @brief A read-only search index built from the inorder sequence of a tree.
+ *
+ * The keys are stored in a single array in Eytzinger (BFS) order: the children of slot k are at
+ * slots 2k and 2k + 1, so a search walks down an implicit complete tree without following pointers.
+ * The first four levels share one cache line and the descent prefetches the line holding the
+ * great-great-grandchildren, which hides most of the memory latency of the deeper levels.
+ *
+ * Elements are addressed by their position in the sorted order, so successor and predecessor
+ * are O(1) position steps.
+ */
+class EytzingerIndex {
+private:
+  std::vector<int> keys;           // Keys in Eytzinger order, slot 0 is unused
+  std::vector<int> ranks;          // Position in sorted order of the key at each slot
+  std::vector<std::string> names;  // City names in sorted order
+  std::vector<int> populations;    // Populations in sorted order
+  int length;                      // Number of elements in the index
+
+  /**
+   * @brief Helper function to fill the Eytzinger slots with an inorder walk of the implicit tree.
+   * @param sortedData The array sorted in ascending order of population.
+   * @param index The next element of the sorted array to be placed.
+   * @param slot The current slot of the implicit tree.
+   */
+  void buildHelper(const std::pair<std::string, int> sortedData[], int &index, int slot) {
+    if (slot <= length) {
+      buildHelper(sortedData, index, 2 * slot);
+      keys[slot] = sortedData[index].second;
+      ranks[slot] = index++;
+      buildHelper(sortedData, index, 2 * slot + 1);
+    }
+  }
+
+  /**
+   * @brief Helper function to find the first slot whose key is not less than the given value.
+   * @param value The value to search for.
+   * @return The slot of the lower bound, or 0 if every key is less than the value.
+   */
+  int lowerBoundSlot(int value) const {
+    const int *base = keys.data();
+    unsigned int slot = 1;
+    while (slot <= static_cast<unsigned int>(length)) {
+      __builtin_prefetch(base + 16 * slot); // Children four levels below share one cache line
+      slot = 2 * slot + (base[slot] < value);
+    }
+    slot >>= __builtin_ffs(~slot); // Undo the right turns taken after the last left turn
+    return slot;
+  }
+
+public:
+  /**
+   * @brief Constructor to build the index from an array sorted by population, e.g. the output of RedBlackTree::inorder.
+   * @param sortedData The array sorted in ascending order of population.
+   * @param length The number of elements in the array.
+   */
+  EytzingerIndex(const std::pair<std::string, int> sortedData[], int length) : length(length) {
+    keys.assign(length + 1, 0);
+    ranks.assign(length + 1, -1);
+    names.reserve(length);
+    populations.reserve(length);
+    for (int i = 0; i < length; i++) {
+      names.push_back(sortedData[i].first);
+      populations.push_back(sortedData[i].second);
+    }
+    int index = 0;
+    buildHelper(sortedData, index, 1);
+  }
+
+  /**
+   * @brief Function to search the index for a given value.
+   * @param value The value to search for.
+   * @return The sorted position of the first element with the given value, if found. Otherwise, returns -1.
+   */
+  int searchTree(int value) const {
+    int slot = lowerBoundSlot(value);
+    if (slot == 0 || keys[slot] != value) {
+      return -1; // Value not found
+    }
+    return ranks[slot];
+  }
+
+  /**
+   * @brief Function to find the first element whose value is not less than the given value.
+   * @param value The value to search for.
+   * @return The sorted position of the lower bound, or -1 if every element is smaller.
+   */
+  int lowerBound(int value) const {
+    int slot = lowerBoundSlot(value);
+    return slot == 0 ? -1 : ranks[slot];
+  }
+
+  /**
+   * @brief Find the successor of an element in the index.
+   * @param position The sorted position of the element.
+   * @return The sorted position of the successor, or -1 if there is none.
+   */
+  int successor(int position) const {
+    if (position < 0 || position + 1 >= length) {
+      return -1; // No successor
+    }
+    return position + 1;
+  }
+
+  /**
+   * @brief Find the predecessor of an element in the index.
+   * @param position The sorted position of the element.
+   * @return The sorted position of the predecessor, or -1 if there is none.
+   */
+  int predecessor(int position) const {
+    if (position <= 0 || position >= length) {
+      return -1; // No predecessor
+    }
+    return position - 1;
+  }
+
+  /**
+   * @brief Gets the city name of the element at the given sorted position.
+   * @param position The sorted position of the element.
+   * @return The city name.
+   */
+  const std::string &getName(int position) const {
+    return names[position];
+  }
+
+  /**
+   * @brief Gets the population of the element at the given sorted position.
+   * @param position The sorted position of the element.
+   * @return The population.
+   */
+  int getData(int position) const {
+    return populations[position];
+  }
+
+  /**
+   * @brief Gets the total number of elements in the index.
+   * @return The total number of elements.
+   */
+  int getTotalNodes() const {
+    return length;
+  }
+
+}; // End of EytzingerIndex class
@@ -1,9 +1,19 @@
 #include "rbt.cpp"
 #include "bst.cpp"
+#include "tree_helpers.cpp"
+#include "avl.cpp"
+#include "treap.cpp"
+#include "splay.cpp"
+#include "snapshot.cpp"
 #include <iostream>
 #include <fstream>
 #include <stdlib.h>
 #include <cassert>
+#include <vector>
+#include <algorithm>
+#include <thread>
+#include <chrono>
+#include <random>
 
 template <class T> bool nullNodeCheck(T *node) {
     // this is implemented as RBT's null can be implemented as sentinel node
@@ -18,18 +28,117 @@ template <class T> bool nullNodeCheck(T *node) {
     return false;
 }
 
+/**
+ * @brief Sorts the cities by population on multiple threads while keeping equal populations in input order.
+ *
+ * The array is split into threadCount chunks, each chunk is stable sorted on its own thread,
+ * and then neighbouring chunks are merged pairwise, again in parallel, until one run remains.
+ *
+ * @param data The array of (city, population) pairs to be sorted.
+ * @param threadCount The number of threads to use.
+ */
+void parallelSort(std::vector<std::pair<std::string, int>> &data, int threadCount) {
+    auto byPopulation = [](const std::pair<std::string, int> &a, const std::pair<std::string, int> &b) {
+        return a.second < b.second;
+    };
+    int length = data.size();
+    if (threadCount < 1) {
+        threadCount = 1;
+    }
+
+    std::vector<int> bounds; // chunk i is [bounds[i], bounds[i + 1])
+    for (int i = 0; i <= threadCount; i++) {
+        bounds.push_back(static_cast<long long>(length) * i / threadCount);
+    }
+
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threadCount; i++) {
+        workers.emplace_back([&, i]() {
+            std::stable_sort(data.begin() + bounds[i], data.begin() + bounds[i + 1], byPopulation);
+        });
+    }
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    for (int width = 1; width < threadCount; width *= 2) { // merge neighbouring runs until one run remains
+        workers.clear();
+        for (int i = 0; i + width < threadCount; i += 2 * width) {
+            int head = bounds[i];
+            int mid = bounds[i + width];
+            int tail = bounds[std::min(i + 2 * width, threadCount)];
+            workers.emplace_back([&data, head, mid, tail, byPopulation]() {
+                std::inplace_merge(data.begin() + head, data.begin() + mid, data.begin() + tail, byPopulation);
+            });
+        }
+        for (std::thread &worker : workers) {
+            worker.join();
+        }
+    }
+}
+
+/**
+ * @brief Times the same workload on one tree engine and prints the results.
+ *
+ * All rows are inserted, every query population is searched together with its successor and
+ * predecessor, and finally all rows are deleted again. The height is printed after the inserts and
+ * after the queries, since a self-adjusting tree changes its shape while it is read.
+ *
+ * @param label The name of the tree engine.
+ * @param data The (city, population) pairs to insert.
+ * @param queries The populations to search for.
+ */
+template <class Tree> void benchmarkTree(const std::string &label, const std::vector<std::pair<std::string, int>> &data, const std::vector<int> &queries) {
+    Tree tree;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (const std::pair<std::string, int> &row : data) {
+        tree.insert(row.first, row.second);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << label << ": insert " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns, height " << tree.getHeight();
+
+    long long checksum = 0; // keeps the queries from being optimized away
+    start = std::chrono::high_resolution_clock::now();
+    for (int value : queries) {
+        auto node = tree.searchTree(value);
+        auto next = tree.successor(node);
+        auto previous = tree.predecessor(node);
+        checksum += (next ? next->data : 0) - (previous ? previous->data : 0);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << ", search + successor + predecessor " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns, height " << tree.getHeight();
+
+    start = std::chrono::high_resolution_clock::now();
+    for (const std::pair<std::string, int> &row : data) {
+        tree.deleteNode(row.second);
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << ", delete " << std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() << " ns (checksum " << checksum << ")" << std::endl;
+}
+
 int main(int argc, char* argv[]) {
     RedBlackTree rbTree;
     BinarySearchTree bsTree;
 
-    if (argc < 3 || argc > 4) {
-        std::cerr << "Usage: " << argv[0] << " <input_filename> <output_filename> [v]" << std::endl;
+    if (argc < 3 || argc > 7) {
+        std::cerr << "Usage: " << argv[0] << " <input_filename> <output_filename> [v] [p] [b] [s]" << std::endl;
         return 1;
     }
 
     bool verbose = false;
-    if (argc == 4 && argv[3][0] == 'v') {
-        verbose = true;
+    bool pipeline = false; // sort the input in parallel and build both trees from the sorted array instead of inserting row by row
+    bool benchmark = false; // compare all tree engines on the same skewed workload and exit
+    bool snapshot = false; // write the Red-Black Tree into snapshot_popN.rbt for RedBlackTreeSnapshot
+    for (int i = 3; i < argc; i++) {
+        if (argv[i][0] == 'v') {
+            verbose = true;
+        } else if (argv[i][0] == 'p') {
+            pipeline = true;
+        } else if (argv[i][0] == 'b') {
+            benchmark = true;
+        } else if (argv[i][0] == 's') {
+            snapshot = true;
+        }
     }
 
     const char* inputFilename = argv[1];
@@ -71,7 +180,7 @@ int main(int argc, char* argv[]) {
     std::string colorArray[2] = {"B", "R"};
 
     int dataLength = 0; // number of cities in the file initially set to 0
-    std::pair<std::string, int> data[20000]; // array of pairs to store the cities and populations
+    std::vector<std::pair<std::string, int>> data; // array of pairs to store the cities and populations
 
     std::string line;
 
@@ -95,17 +204,55 @@ int main(int argc, char* argv[]) {
                 }     
             
             int population = stoi(line.substr(pos + 1));
-            data[dataLength++] = std::make_pair(city, population);
+            data.push_back(std::make_pair(city, population));
+            dataLength++;
         }
     }
 
     file.close();
 
+    if (benchmark) {
+        if (dataLength == 0) {
+            std::cerr << "No rows to benchmark." << std::endl;
+            return 1;
+        }
+        // skewed query mix: 80% of the queries hit the first 1% of the cities, the rest are uniform
+        std::mt19937 generator(335);
+        std::uniform_int_distribution<int> hot(0, std::max(0, dataLength / 100 - 1));
+        std::uniform_int_distribution<int> any(0, dataLength - 1);
+        std::vector<int> queries(dataLength);
+        for (int i = 0; i < dataLength; i++) {
+            queries[i] = data[generator() % 5 != 0 ? hot(generator) : any(generator)].second;
+        }
+        benchmarkTree<RedBlackTree>("RBT", data, queries);
+        benchmarkTree<BinarySearchTree>("BST", data, queries);
+        benchmarkTree<AVLTree>("AVL", data, queries);
+        benchmarkTree<Treap>("Treap", data, queries);
+        benchmarkTree<SplayTree>("Splay", data, queries);
+        return 0;
+    }
 
-    // Insert the data into the trees
-    for (int i = 0; i < dataLength; i++) {
-        rbTree.insert(data[i].first, data[i].second);
-        bsTree.insert(data[i].first, data[i].second);
+    auto start = std::chrono::high_resolution_clock::now();
+    if (pipeline) {
+        int threadCount = std::max(1u, std::thread::hardware_concurrency());
+        int threadDepth = 0; // 2^threadDepth subtrees are built in parallel
+        while ((2 << threadDepth) <= threadCount) {
+            threadDepth++;
+        }
+        parallelSort(data, threadCount);
+        rbTree.buildFromSorted(data.data(), dataLength, threadDepth);
+        bsTree.buildFromSorted(data.data(), dataLength, threadDepth);
+    } else {
+        // Insert the data into the trees
+        for (int i = 0; i < dataLength; i++) {
+            rbTree.insert(data[i].first, data[i].second);
+            bsTree.insert(data[i].first, data[i].second);
+        }
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start); // in nanoseconds
+    if (pipeline || verbose) { // the default output stays as it was
+        std::cout << "Time taken by " << (pipeline ? "sort-then-build pipeline" : "insert loop") << " for " << dataLength << " rows: " << duration.count() << " ns." << std::endl;
     }
     
     // open a log file named "log.txt"
@@ -285,22 +432,22 @@ int main(int argc, char* argv[]) {
     }
 
     // create a std::pair<std::string, int> array to store the ordered list of cities and populations
-    std::pair<std::string, int> orderedDataRB[20000];
+    std::vector<std::pair<std::string, int>> orderedDataRB(dataLength);
     // call inorder on the red black tree, passing in the std::pair<std::string, int> array and the length of the array
     // this will populate the array with the ordered list of cities and populations
     // you can get help about insertion from 98th line above:
     //data[dataLength++] = std::make_pair(city, population);
     //0 is starting index for the pair array of cities sorted according to the population
-    rbTree.inorder(orderedDataRB,0);
+    rbTree.inorder(orderedDataRB.data(),0);
 
     // create a std::pair<std::string, int> array to store the ordered list of cities and populations
-    std::pair<std::string, int> orderedDataBST[20000];
+    std::vector<std::pair<std::string, int>> orderedDataBST(dataLength);
     // call inorder on the binary search tree, passing in the std::pair<std::string, int> array and the length of the array
     // this will populate the array with the ordered list of cities and populations
     // you can get help about insertion from 98th line above:
     //data[dataLength++] = std::make_pair(city, population);
     //0 is starting index for the pair array of cities sorted according to the population
-    bsTree.inorder(orderedDataBST,0);
+    bsTree.inorder(orderedDataBST.data(),0);
 
     // remove the extension of the outputFilename
     std::string outputFilenameStr = outputFilename;
@@ -364,5 +511,15 @@ int main(int argc, char* argv[]) {
 
     logFile.close();
 
+    if (snapshot) {
+        writeSnapshot(rbTree, ("snapshot_pop" + std::to_string(dataNumber) + ".rbt").c_str());
+    }
+
+#ifdef RBT_STATS
+    // write the Red-Black Tree counters next to the log file
+    std::ofstream statsFile("stats_pop" + std::to_string(dataNumber) + ".txt");
+    rbTree.dumpStats(statsFile);
+#endif
+
     return 0;
 }
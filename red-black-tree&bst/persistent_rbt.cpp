@@ -0,0 +1,396 @@
+// Implementing a persistent (path copying) Red-Black Tree in C++
+// rbt.cpp must be included before this file
+
+/**
+  BLG335E - Analysis of Algorithms I - Project 3
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+
+/**
+ * @brief Node struct to hold attributes of each immutable node inside a namespace for the persistent Red-Black Tree.
+ *
+ * Nodes are shared between versions and never modified after construction, so there is no parent
+ * pointer. A node is freed when the last version referring to it is released.
+ */
+namespace PRBT {
+  struct Node;
+  typedef std::shared_ptr<const Node> NodePtr;
+
+  struct Node {
+    Node(int color, NodePtr left, const std::string &name, int data, NodePtr right)
+        : data(data), name(name), left(left), right(right), color(color) {}
+    int data;
+    std::string name;
+    NodePtr left;
+    NodePtr right;
+    int color;  // Uses the Color enum of rbt.cpp, BLACK -> 0, RED -> 1
+  };
+}
+
+/**
+ * @brief A class representing one version of a persistent Red-Black Tree.
+ *
+ * insert and deleteNode copy only the nodes on the root-to-leaf path, at most O(log n) of them, and
+ * return the new version; every other node is shared. Old versions stay valid and readable for as long
+ * as they are held, which makes a copy of a version a consistent snapshot. Versions are reclaimed by
+ * reference counting. The rebalancing follows Okasaki's insertion and Kahrs' deletion.
+ */
+class PersistentRedBlackTree {
+private:
+  PRBT::NodePtr root; // Root of this version
+
+  /**
+   * @brief Constructor to wrap the given root as a version.
+   * @param root The root of the version.
+   */
+  explicit PersistentRedBlackTree(PRBT::NodePtr root) : root(root) {}
+
+  /**
+   * @brief Helper function to check whether the given node is red, null nodes are black.
+   * @param node The node to check.
+   * @return True if the node is red, otherwise false.
+   */
+  static bool isRed(const PRBT::NodePtr &node) {
+    return node != nullptr && node->color == RED;
+  }
+
+  /**
+   * @brief Helper function to check whether the given node is a real black node, null nodes do not count.
+   * @param node The node to check.
+   * @return True if the node exists and is black, otherwise false.
+   */
+  static bool isBlack(const PRBT::NodePtr &node) {
+    return node != nullptr && node->color == BLACK;
+  }
+
+  /**
+   * @brief Helper function to allocate a new node copying the name and data of the given key node.
+   * @param color The color of the new node.
+   * @param left The left child of the new node.
+   * @param key The node holding the name and data.
+   * @param right The right child of the new node.
+   * @return The new node.
+   */
+  static PRBT::NodePtr makeNode(int color, const PRBT::NodePtr &left, const PRBT::NodePtr &key, const PRBT::NodePtr &right) {
+    return std::make_shared<const PRBT::Node>(color, left, key->name, key->data, right);
+  }
+
+  /**
+   * @brief Helper function to rebuild a black node, resolving a red-red violation in its children or grandchildren.
+   * @param a The left subtree.
+   * @param key The node holding the name and data of the new node.
+   * @param b The right subtree.
+   * @return The rebalanced subtree.
+   */
+  static PRBT::NodePtr balance(const PRBT::NodePtr &a, const PRBT::NodePtr &key, const PRBT::NodePtr &b) {
+    if (isRed(a) && isRed(b)) {
+      return makeNode(RED, makeNode(BLACK, a->left, a, a->right), key, makeNode(BLACK, b->left, b, b->right));
+    }
+    if (isRed(a) && isRed(a->left)) {
+      return makeNode(RED, makeNode(BLACK, a->left->left, a->left, a->left->right), a, makeNode(BLACK, a->right, key, b));
+    }
+    if (isRed(a) && isRed(a->right)) {
+      return makeNode(RED, makeNode(BLACK, a->left, a, a->right->left), a->right, makeNode(BLACK, a->right->right, key, b));
+    }
+    if (isRed(b) && isRed(b->right)) {
+      return makeNode(RED, makeNode(BLACK, a, key, b->left), b, makeNode(BLACK, b->right->left, b->right, b->right->right));
+    }
+    if (isRed(b) && isRed(b->left)) {
+      return makeNode(RED, makeNode(BLACK, a, key, b->left->left), b->left, makeNode(BLACK, b->left->right, b, b->right));
+    }
+    return makeNode(BLACK, a, key, b);
+  }
+
+  /**
+   * @brief Helper function to turn a black node red, used when its subtree must lose one black level.
+   * @param node The black node.
+   * @return The same subtree with a red root.
+   */
+  static PRBT::NodePtr redden(const PRBT::NodePtr &node) {
+    if (!isBlack(node)) {
+      throw std::logic_error("Red-Black Tree invariant violated during deletion");
+    }
+    return makeNode(RED, node->left, node, node->right);
+  }
+
+  /**
+   * @brief Helper function to rebalance a node whose left subtree has lost one black level.
+   * @param left The shortened left subtree.
+   * @param key The node holding the name and data.
+   * @param right The right subtree.
+   * @return The rebalanced subtree.
+   */
+  static PRBT::NodePtr balanceLeft(const PRBT::NodePtr &left, const PRBT::NodePtr &key, const PRBT::NodePtr &right) {
+    if (isRed(left)) {
+      return makeNode(RED, makeNode(BLACK, left->left, left, left->right), key, right);
+    }
+    if (isBlack(right)) {
+      return balance(left, key, makeNode(RED, right->left, right, right->right));
+    }
+    if (isRed(right) && isBlack(right->left)) {
+      return makeNode(RED, makeNode(BLACK, left, key, right->left->left), right->left,
+                      balance(right->left->right, right, redden(right->right)));
+    }
+    throw std::logic_error("Red-Black Tree invariant violated during deletion");
+  }
+
+  /**
+   * @brief Helper function to rebalance a node whose right subtree has lost one black level.
+   * @param left The left subtree.
+   * @param key The node holding the name and data.
+   * @param right The shortened right subtree.
+   * @return The rebalanced subtree.
+   */
+  static PRBT::NodePtr balanceRight(const PRBT::NodePtr &left, const PRBT::NodePtr &key, const PRBT::NodePtr &right) {
+    if (isRed(right)) {
+      return makeNode(RED, left, key, makeNode(BLACK, right->left, right, right->right));
+    }
+    if (isBlack(left)) {
+      return balance(makeNode(RED, left->left, left, left->right), key, right);
+    }
+    if (isRed(left) && isBlack(left->right)) {
+      return makeNode(RED, balance(redden(left->left), left, left->right->left), left->right,
+                      makeNode(BLACK, left->right->right, key, right));
+    }
+    throw std::logic_error("Red-Black Tree invariant violated during deletion");
+  }
+
+  /**
+   * @brief Helper function to join two subtrees of equal black height whose keys are in order.
+   * @param a The left subtree.
+   * @param b The right subtree, all keys not less than the keys of a.
+   * @return The joined subtree.
+   */
+  static PRBT::NodePtr append(const PRBT::NodePtr &a, const PRBT::NodePtr &b) {
+    if (a == nullptr) {
+      return b;
+    }
+    if (b == nullptr) {
+      return a;
+    }
+    if (isRed(a) && isRed(b)) {
+      PRBT::NodePtr middle = append(a->right, b->left);
+      if (isRed(middle)) {
+        return makeNode(RED, makeNode(RED, a->left, a, middle->left), middle, makeNode(RED, middle->right, b, b->right));
+      }
+      return makeNode(RED, a->left, a, makeNode(RED, middle, b, b->right));
+    }
+    if (isBlack(a) && isBlack(b)) {
+      PRBT::NodePtr middle = append(a->right, b->left);
+      if (isRed(middle)) {
+        return makeNode(RED, makeNode(BLACK, a->left, a, middle->left), middle, makeNode(BLACK, middle->right, b, b->right));
+      }
+      return balanceLeft(a->left, a, makeNode(BLACK, middle, b, b->right));
+    }
+    if (isRed(b)) {
+      return makeNode(RED, append(a, b->left), b, b->right);
+    }
+    return makeNode(RED, a->left, a, append(a->right, b));
+  }
+
+  /**
+   * @brief Helper function to insert a node below the given node, copying the path to it.
+   * @param node The root of the subtree.
+   * @param key The new node, red with no children.
+   * @return The new root of the subtree, its root may be red with a red child.
+   */
+  static PRBT::NodePtr insertHelper(const PRBT::NodePtr &node, const PRBT::NodePtr &key) {
+    if (node == nullptr) {
+      return key;
+    }
+    if (key->data < node->data) { // Equal keys go right, so equal populations stay in insertion order
+      PRBT::NodePtr left = insertHelper(node->left, key);
+      return node->color == BLACK ? balance(left, node, node->right) : makeNode(RED, left, node, node->right);
+    }
+    PRBT::NodePtr right = insertHelper(node->right, key);
+    return node->color == BLACK ? balance(node->left, node, right) : makeNode(RED, node->left, node, right);
+  }
+
+  /**
+   * @brief Helper function to delete the first node with the given value found below the given node.
+   * @param node The root of the subtree, it must contain the value.
+   * @param value The value to delete.
+   * @return The new root of the subtree, one black level shorter if the old root was black.
+   */
+  static PRBT::NodePtr deleteHelper(const PRBT::NodePtr &node, int value) {
+    if (value < node->data) {
+      PRBT::NodePtr left = deleteHelper(node->left, value);
+      return isBlack(node->left) ? balanceLeft(left, node, node->right) : makeNode(RED, left, node, node->right);
+    }
+    if (value > node->data) {
+      PRBT::NodePtr right = deleteHelper(node->right, value);
+      return isBlack(node->right) ? balanceRight(node->left, node, right) : makeNode(RED, node->left, node, right);
+    }
+    return append(node->left, node->right);
+  }
+
+  /**
+   * @brief Helper function to traverse the tree in inorder and store the data in the given array.
+   * @param node The current node being traversed.
+   * @param orderedData The array to store the data in.
+   * @param index The index of the array to store the data in.
+   */
+  static void inorderHelper(const PRBT::Node *node, std::pair<std::string, int> orderedData[], int &index) {
+    if (node) {
+      inorderHelper(node->left.get(), orderedData, index);
+      orderedData[index++] = std::make_pair(node->name, node->data);
+      inorderHelper(node->right.get(), orderedData, index);
+    }
+  }
+
+  /**
+   * @brief Helper function to get the height of the tree.
+   * @param node The current node being traversed.
+   * @return The total count of nodes in tree. To get the height, subtract 1 from the result.
+   */
+  static int getHeightHelper(const PRBT::Node *node) {
+    if (node == nullptr) { // Base case: reached a null node
+      return 0;
+    }
+    return 1 + std::max(getHeightHelper(node->left.get()), getHeightHelper(node->right.get()));
+  }
+
+  /**
+   * @brief Helper function to count the total number of nodes in the tree.
+   * @param node The initial root of the subtree.
+   * @return The total count of nodes in tree.
+   */
+  static int countNodes(const PRBT::Node *node) {
+    if (node == nullptr) {
+      return 0; // Base case: reached a null node
+    }
+    return 1 + countNodes(node->left.get()) + countNodes(node->right.get());
+  }
+
+public:
+  /**
+   * @brief Constructor to create the empty version.
+   */
+  PersistentRedBlackTree() {}
+
+  /**
+   * @brief Returns a new version with the given city inserted, this version is left unchanged.
+   * @param name The name of the city.
+   * @param data The population of the city.
+   * @return The new version.
+   */
+  PersistentRedBlackTree insert(const std::string &name, int data) const {
+    PRBT::NodePtr key = std::make_shared<const PRBT::Node>(RED, nullptr, name, data, nullptr); // New node is always red
+    PRBT::NodePtr newRoot = insertHelper(root, key);
+    if (isRed(newRoot)) {
+      newRoot = makeNode(BLACK, newRoot->left, newRoot, newRoot->right); // Ensure the root is black
+    }
+    return PersistentRedBlackTree(newRoot);
+  }
+
+  /**
+   * @brief Returns a new version without the node that searchTree finds for the given value, this version is left unchanged.
+   * @param data The population of the city to be deleted.
+   * @return The new version, or a copy of this version if the value is not found.
+   */
+  PersistentRedBlackTree deleteNode(int data) const {
+    if (searchTree(data) == nullptr) {
+      return *this; // Node with the given value not found
+    }
+    PRBT::NodePtr newRoot = deleteHelper(root, data);
+    if (isRed(newRoot)) {
+      newRoot = makeNode(BLACK, newRoot->left, newRoot, newRoot->right); // Ensure the root is black
+    }
+    return PersistentRedBlackTree(newRoot);
+  }
+
+  /**
+   * @brief Function to search the tree iteratively for a given value.
+   * @param value The value to search for.
+   * @return The node with the given value, if found. Otherwise, returns null. It stays valid while this version is held.
+   */
+  const PRBT::Node *searchTree(int value) const {
+    const PRBT::Node *current = root.get();
+    while (current != nullptr && value != current->data) {
+      current = value < current->data ? current->left.get() : current->right.get();
+    }
+    return current;
+  }
+
+  /**
+   * @brief Find the node with the smallest value greater than the given value.
+   *
+   * Nodes have no parent pointer, so unlike RedBlackTree::successor this takes a value and descends from the root.
+   *
+   * @param value The value whose successor is searched.
+   * @return The successor node, or null if there is none.
+   */
+  const PRBT::Node *successor(int value) const {
+    const PRBT::Node *current = root.get();
+    const PRBT::Node *candidate = nullptr;
+    while (current != nullptr) {
+      if (value < current->data) {
+        candidate = current; // Last node where the search turned left
+        current = current->left.get();
+      } else {
+        current = current->right.get();
+      }
+    }
+    return candidate;
+  }
+
+  /**
+   * @brief Find the node with the largest value smaller than the given value.
+   * @param value The value whose predecessor is searched.
+   * @return The predecessor node, or null if there is none.
+   */
+  const PRBT::Node *predecessor(int value) const {
+    const PRBT::Node *current = root.get();
+    const PRBT::Node *candidate = nullptr;
+    while (current != nullptr) {
+      if (value > current->data) {
+        candidate = current; // Last node where the search turned right
+        current = current->right.get();
+      } else {
+        current = current->left.get();
+      }
+    }
+    return candidate;
+  }
+
+  /**
+   * @brief Function to traverse the tree in inorder and store the data in the given array.
+   * @param orderedData The array to store the data in.
+   * @param startIndex The starting index of the array to store the data in.
+   */
+  void inorder(std::pair<std::string, int> orderedData[], int startIndex) const {
+    int index = startIndex;
+    inorderHelper(root.get(), orderedData, index);
+  }
+
+  /**
+   * @brief Function to get the height of the tree.
+   * @return The height of the tree.
+   */
+  int getHeight() const {
+    return getHeightHelper(root.get()) - 1; // (Count of nodes from top  to bottom) - 1 = height
+  }
+
+  /**
+   * @brief Gets the total number of nodes in this version.
+   * @return The total number of nodes, or 0 if the version is empty.
+   */
+  int getTotalNodes() const {
+    return countNodes(root.get());
+  }
+
+  /**
+   * @brief Gets the root of this version, mainly for validating the tree.
+   * @return The root node, or null if the version is empty.
+   */
+  const PRBT::Node *getRoot() const {
+    return root.get();
+  }
+
+}; // End of PersistentRedBlackTree class
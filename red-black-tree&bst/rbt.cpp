@@ -9,19 +9,54 @@
 */
 
 #include <iostream>
+#include <thread>
+#include <functional>
+#include <memory>
+#include <atomic>
+
+/**
+ * @brief Statistics are compiled in only when RBT_STATS is defined (e.g. g++ -DRBT_STATS main.cpp).
+ * Otherwise RBT_STAT expands to nothing, so the tree carries no counters and does no extra work.
+ */
+#ifdef RBT_STATS
+#define RBT_STAT(statement) statement
+#else
+#define RBT_STAT(statement)
+#endif
 
 /**
  * @brief Node struct to hold attributes of each node inside a namespace for the Red-Black Tree.
+ *
+ * The key is kept in data and the value in name, as for the population-keyed city tree.
  */
 namespace RBT {
-  struct Node {
-    int data;
-    std::string name;
-    Node *parent;
-    Node *left;
-    Node *right;
+  template <class Key, class Value> struct BasicNode {
+    Key data;
+    Value name;
+    BasicNode *parent;
+    BasicNode *left;
+    BasicNode *right;
     int color;  // Color attribute additional to BST
   };
+
+  typedef BasicNode<int, std::string> Node; // Node of the city tree keyed by population
+
+  /**
+   * @brief Counters collected by a Red-Black Tree built with RBT_STATS.
+   *
+   * The search counters are updated by searchTree, which may run on several reader threads at once, so they
+   * are atomic. The other counters are only updated by writers.
+   */
+  struct Stats {
+    long long rotations = 0;              // Left and right rotations
+    long long recolors = 0;               // Color assignments made by insertFixup and deleteFixup
+    long long insertFixupIterations = 0;  // Iterations of the insertFixup loop
+    long long deleteFixupIterations = 0;  // Iterations of the deleteFixup loop
+    long long allocations = 0;            // Nodes allocated
+    long long frees = 0;                  // Nodes freed
+    std::atomic<long long> searches{0};                // Calls of searchTree(value)
+    std::atomic<long long> searchPathLengths[64] = {}; // searchPathLengths[k] searches visited k nodes, the last bucket also holds longer paths
+  };
 }
 
 /**
@@ -31,72 +66,173 @@ enum Color {BLACK, RED};
 
 /**
  * @brief A class representing a Red-Black Tree.
+ *
+ * Nodes are ordered by key with the comparator, equal keys staying in insertion order, and are allocated
+ * through the allocator. The comparator is a template argument, so calls to it are inlined just like
+ * the built-in comparison of ints. If Compare defines is_transparent (e.g. std::less<>), the lookups also
+ * accept any type that the comparator can compare with Key, without building a Key first.
+ *
+ * @tparam Key The type of the keys, e.g. the population.
+ * @tparam Value The type of the values, e.g. the city name.
+ * @tparam Compare The strict weak ordering of the keys.
+ * @tparam Alloc The allocator, rebound to allocate nodes.
  */
-class RedBlackTree {
+template <class Key, class Value, class Compare = std::less<Key>, class Alloc = std::allocator<RBT::BasicNode<Key, Value>>>
+class BasicRedBlackTree {
+public:
+  typedef RBT::BasicNode<Key, Value> Node;
+
 private:
-  RBT::Node *root; // Root of the tree
+  typedef typename std::allocator_traits<Alloc>::template rebind_alloc<Node> NodeAllocator;
+  typedef std::allocator_traits<NodeAllocator> NodeAllocatorTraits;
+
+  Node *root; // Root of the tree
+  Compare compare; // Orders the keys
+  NodeAllocator allocator; // Allocates the nodes
+#ifdef RBT_STATS
+  RBT::Stats stats; // Counters of the tree, see RBT::Stats
+#endif
 
   /**
-   * @brief Helper function to recursively delete nodes starting from the given node.
-   * @param node The current node being deleted.
+   * @brief Helper function to allocate and construct a node through the allocator.
+   * @return The new node with default constructed key and value.
    */
-  void destroyTree(RBT::Node* node) {
-    if (node != nullptr) {
-      destroyTree(node->left);  // Recursively delete left subtree
-      destroyTree(node->right); // Recursively delete right subtree
-      delete node;              // Delete the current node
-      node = nullptr;           // Set the current node to null to avoid dangling pointer
+  Node *createNode() {
+    Node *node = NodeAllocatorTraits::allocate(allocator, 1);
+    NodeAllocatorTraits::construct(allocator, node);
+    return node;
+  }
+
+  /**
+   * @brief Helper function to destroy and free a node through the allocator.
+   * @param node The node to be freed.
+   */
+  void destroyNode(Node *node) {
+    NodeAllocatorTraits::destroy(allocator, node);
+    NodeAllocatorTraits::deallocate(allocator, node, 1);
+  }
+
+  /**
+   * @brief Helper function to iteratively delete nodes starting from the given node.
+   *
+   * Nodes are deleted in postorder by following parent pointers, so no stack is used and a degenerate
+   * tree of any height can be freed.
+   *
+   * @param node The root of the subtree being deleted.
+   */
+  void destroyTree(Node* node) {
+    if (node == nullptr) {
+      return;
+    }
+    Node* stop = node->parent; // Parent of the subtree, the walk ends when it is reached
+    Node* current = findFirstLeaf(node);
+    while (current != nullptr) {
+      Node* parent = current->parent;
+      Node* next;
+      if (parent == stop) {
+        next = nullptr;                         // The subtree root is deleted last
+      } else if (current == parent->left && parent->right != nullptr) {
+        next = findFirstLeaf(parent->right);    // Delete the right subtree before the parent
+      } else {
+        next = parent;
+      }
+      destroyNode(current); // Delete the current node, its children are already deleted
+      current = next;
     }
   }
 
   /**
-   * @brief Helper function to traverse the tree in preorder and store the data in the given array.
-   * @param node The current node being traversed.
+   * @brief Helper function to traverse the tree in preorder iteratively and store the data in the given array.
+   * @param node The root of the subtree being traversed.
    * @param orderedData The array to store the data in.
    * @param index The index of the array to store the data in.
    */
-  void preorderHelper(RBT::Node *node, std::pair<std::string, int> orderedData[], int &index) {
-    if (node) {
-      orderedData[index++] = std::make_pair(node->name, node->data);
-      preorderHelper(node->left, orderedData, index);
-      preorderHelper(node->right, orderedData, index);
+  void preorderHelper(Node *node, std::pair<Value, Key> orderedData[], int &index) {
+    Node *stop = node != nullptr ? node->parent : nullptr;
+    Node *current = node;
+    while (current != nullptr) {
+      orderedData[index++] = std::make_pair(current->name, current->data);
+      if (current->left != nullptr) {
+        current = current->left;
+      } else if (current->right != nullptr) {
+        current = current->right;
+      } else { // Climb until an ancestor has a right subtree that is not visited yet
+        while (current->parent != stop && (current == current->parent->right || current->parent->right == nullptr)) {
+          current = current->parent;
+        }
+        current = current->parent != stop ? current->parent->right : nullptr;
+      }
     }
   }
 
   /**
-   * @brief Helper function to traverse the tree in inorder and store the data in the given array.
-   * @param node The current node being traversed.
+   * @brief Helper function to traverse the tree in inorder iteratively and store the data in the given array.
+   * @param node The root of the subtree being traversed.
    * @param orderedData The array to store the data in.
    * @param index The index of the array to store the data in.
    */
-  void inorderHelper(RBT::Node *node, std::pair<std::string, int> orderedData[], int &index) {
-    if (node) {
-      inorderHelper(node->left, orderedData, index);
-      orderedData[index++] = std::make_pair(node->name, node->data);
-      inorderHelper(node->right, orderedData, index);
+  void inorderHelper(Node *node, std::pair<Value, Key> orderedData[], int &index) {
+    if (node == nullptr) {
+      return;
+    }
+    Node *stop = node->parent;
+    Node *current = findMin(node);
+    while (current != nullptr) {
+      orderedData[index++] = std::make_pair(current->name, current->data);
+      if (current->right != nullptr) {
+        current = findMin(current->right);
+      } else { // Climb until coming up from a left child
+        while (current->parent != stop && current == current->parent->right) {
+          current = current->parent;
+        }
+        current = current->parent != stop ? current->parent : nullptr;
+      }
     }
   }
 
   /**
-   * @brief Helper function to traverse the tree in postorder and store the data in the given array.
-   * @param node The current node being traversed.
+   * @brief Helper function to traverse the tree in postorder iteratively and store the data in the given array.
+   * @param node The root of the subtree being traversed.
    * @param orderedData The array to store the data in.
    * @param index The index of the array to store the data in.
    */
-  void postorderHelper(RBT::Node *node, std::pair<std::string, int> orderedData[], int &index) {
-    if (node) {
-      postorderHelper(node->left, orderedData, index);
-      postorderHelper(node->right, orderedData, index);
-      orderedData[index++] = std::make_pair(node->name, node->data);
+  void postorderHelper(Node *node, std::pair<Value, Key> orderedData[], int &index) {
+    if (node == nullptr) {
+      return;
+    }
+    Node *stop = node->parent;
+    Node *current = findFirstLeaf(node);
+    while (current != nullptr) {
+      orderedData[index++] = std::make_pair(current->name, current->data);
+      Node *parent = current->parent;
+      if (parent == stop) {
+        current = nullptr;
+      } else if (current == parent->left && parent->right != nullptr) {
+        current = findFirstLeaf(parent->right);
+      } else {
+        current = parent;
+      }
+    }
+  }
+
+  /**
+   * @brief Helper function to find the first node of the subtree in postorder, the leaf reached by preferring left children.
+   * @param node The root of the subtree.
+   * @return The first leaf of the subtree.
+   */
+  Node *findFirstLeaf(Node *node) {
+    while (node->left != nullptr || node->right != nullptr) {
+      node = node->left != nullptr ? node->left : node->right;
     }
+    return node;
   }
 
   /**
   * @brief Performs a left rotation on the nodes of the RBT to the left, preserving the Red-Black Tree properties.
   * @param x The node around which the left rotation is performed.
   */
-  void leftRotate(RBT::Node* x) {
-    RBT::Node* y = x->right;
+  void leftRotate(Node* x) {
+    Node* y = x->right;
     x->right = y->left;
     if (y->left != nullptr)
       y->left->parent = x;
@@ -112,14 +248,15 @@ private:
 
     y->left = x;
     x->parent = y;
+    RBT_STAT(stats.rotations++);
   }
 
   /**
   * @brief Performs a right rotation on the nodes of the RBT to the right, preserving the Red-Black Tree properties.
   * @param x The node around which the left rotation is performed.
   */
-  void rightRotate(RBT::Node* y) {
-    RBT::Node* x = y->left;
+  void rightRotate(Node* y) {
+    Node* x = y->left;
     y->left = x->right;
     if (x->right != nullptr)
       x->right->parent = y;
@@ -135,22 +272,45 @@ private:
 
     x->right = y;
     y->parent = x;
+    RBT_STAT(stats.rotations++);
   }
 
   /**
    * @brief Helper function to get the height of the tree.
-   * @param node The current node being traversed.
+   *
+   * The subtree is walked iteratively by following parent pointers: a node entered from its parent goes one level
+   * deeper, and the previously visited node tells which child to visit next, so only O(1) extra space is used.
+   *
+   * @param node The root of the subtree being traversed.
    * @return The total count of nodes in tree. To get the height, subtract 1 from the result. 
    */
-  int getHeightHelper(RBT::Node *node) {
-    if (node == nullptr) { // Base case: reached a null node
+  int getHeightHelper(Node *node) {
+    if (node == nullptr) { // Base case: empty tree
       return 0;
     }
-
-    int leftHeight = getHeightHelper(node->left);
-    int rightHeight = getHeightHelper(node->right);
-
-    return 1 + std::max(leftHeight, rightHeight); // Add 1 for the current node
+    Node *stop = node->parent;
+    Node *previous = stop;
+    Node *current = node;
+    int depth = 0;
+    int height = 0;
+    while (current != stop) {
+      Node *next;
+      if (previous == current->parent) { // Entered from the parent
+        depth++;
+        height = std::max(height, depth);
+        next = current->left != nullptr ? current->left : (current->right != nullptr ? current->right : current->parent);
+      } else if (previous == current->left) { // Came back from the left child
+        next = current->right != nullptr ? current->right : current->parent;
+      } else { // Came back from the right child
+        next = current->parent;
+      }
+      if (next == current->parent) {
+        depth--;
+      }
+      previous = current;
+      current = next;
+    }
+    return height;
   }
 
   /**
@@ -158,7 +318,7 @@ private:
    * @param node The initial root of the subtree.
    * @return The node with the minimum value in the tree rooted with given node.
    */
-  RBT::Node *findMin(RBT::Node *node) {
+  Node *findMin(Node *node) {
     while (node->left != nullptr) {
       node = node->left;
     }
@@ -170,7 +330,7 @@ private:
    * @param node The initial root of the subtree.
    * @return The node with the maximum value in the tree rooted with given node.
    */
-  RBT::Node *findMax(RBT::Node *node) {
+  Node *findMax(Node *node) {
     while (node->right != nullptr) {
       node = node->right;
     }
@@ -182,12 +342,47 @@ private:
    * @param node The initial root of the subtree, when called with root it simply count all nodes.
    * @return The total count of nodes in tree.
    */
-  int countNodes(RBT::Node *node) {
+  int countNodes(Node *node) {
     if (node == nullptr) {
-      return 0; // Base case: reached a null node
+      return 0; // Base case: empty tree
     }
+    int count = 0;
+    Node *stop = node->parent;
+    Node *current = findMin(node);
+    while (current != nullptr) { // Same inorder walk as inorderHelper
+      count++;
+      if (current->right != nullptr) {
+        current = findMin(current->right);
+      } else {
+        while (current->parent != stop && current == current->parent->right) {
+          current = current->parent;
+        }
+        current = current->parent != stop ? current->parent : nullptr;
+      }
+    }
+    return count;
+  }
 
-    return 1 + countNodes(node->left) + countNodes(node->right); // Add 1 for the current node
+  /**
+   * @brief Helper function to search the tree iteratively for a key equivalent to the given value.
+   * @param value The value to search for.
+   * @return The node with the given value, if found. Otherwise, returns null.
+   */
+  template <class K> Node* find(const K& value) {
+    Node* current = root;
+    RBT_STAT(int pathLength = 0); // Number of nodes compared with the value
+    while (current != nullptr) {
+      RBT_STAT(pathLength++);
+      if (compare(value, current->data)) {
+        current = current->left;
+      } else if (compare(current->data, value)) {
+        current = current->right;
+      } else {
+        break;
+      }
+    }
+    RBT_STAT(recordSearch(pathLength));
+    return current;
   }
 
   /**
@@ -195,7 +390,7 @@ private:
    * @param u The node to be replaced.
    * @param v The node to replace the node u.
    */
-  void transplant(RBT::Node* u, RBT::Node* v) {
+  void transplant(Node* u, Node* v) {
     if (u->parent == nullptr) {
       root = v;
     } else if (u == u->parent->left) {
@@ -209,6 +404,45 @@ private:
     }
   }
 
+  /**
+   * @brief Helper function to build a balanced subtree from the sorted range [head, tail] of the given array.
+   *
+   * The middle element becomes the subtree root, so every leaf ends up on one of the two deepest levels.
+   * Only the nodes on the deepest level are colored red, which keeps the black height equal on all paths.
+   *
+   * @param sortedData The array sorted in ascending order of population.
+   * @param head Index of the first element of the range.
+   * @param tail Index of the last element of the range.
+   * @param parent The parent of the subtree to be built.
+   * @param depth The depth of the subtree root, root of the tree is at depth 0.
+   * @param redDepth The depth of the deepest level, nodes at this depth are colored red.
+   * @param threadDepth The number of levels below this one whose left subtrees are built on separate threads.
+   * @return The root of the built subtree, or null if the range is empty.
+   */
+  Node *buildHelper(const std::pair<Value, Key> sortedData[], int head, int tail, Node *parent, int depth, int redDepth, int threadDepth) {
+    if (head > tail) {
+      return nullptr; // Base case: empty range
+    }
+
+    int mid = head + (tail - head) / 2;
+    Node *node = createNode();
+    node->name = sortedData[mid].first;
+    node->data = sortedData[mid].second;
+    node->parent = parent;
+    node->color = (depth == redDepth && depth > 0) ? RED : BLACK;
+    if (threadDepth > 0) { // Build the left subtree on a separate thread, the ranges are disjoint so no locking is needed
+      std::thread leftBuilder([&]() {
+        node->left = buildHelper(sortedData, head, mid - 1, node, depth + 1, redDepth, threadDepth - 1);
+      });
+      node->right = buildHelper(sortedData, mid + 1, tail, node, depth + 1, redDepth, threadDepth - 1);
+      leftBuilder.join();
+    } else {
+      node->left = buildHelper(sortedData, head, mid - 1, node, depth + 1, redDepth, 0);
+      node->right = buildHelper(sortedData, mid + 1, tail, node, depth + 1, redDepth, 0);
+    }
+    return node;
+  }
+
   /**
   * @brief Performs fixup operations on the Red-Black Tree (RBT) after node insertion.
   *
@@ -217,15 +451,17 @@ private:
   *
   * @param z The newly inserted node that may violate the Red-Black Tree properties.
   */
-  void insertFixup(RBT::Node* z) {
+  void insertFixup(Node* z) {
     while (z->parent && z->parent->color == RED) {
+      RBT_STAT(stats.insertFixupIterations++);
       if (z->parent == z->parent->parent->left) {
-        RBT::Node* y = z->parent->parent->right;
+        Node* y = z->parent->parent->right;
         if (y && y->color == RED) {
           z->parent->color = BLACK;          // Case 1
           y->color = BLACK;                  // Case 1
           z->parent->parent->color = RED;    // Case 1
           z = z->parent->parent;             // Case 1
+          RBT_STAT(stats.recolors += 3);
         } else {
           if (z == z->parent->right) {
             z = z->parent;                   // Case 2
@@ -234,14 +470,16 @@ private:
           z->parent->color = BLACK;           // Case 3
           z->parent->parent->color = RED;     // Case 3
           rightRotate(z->parent->parent);  // Case 3
+          RBT_STAT(stats.recolors += 2);
         }
       } else {
-        RBT::Node* y = z->parent->parent->left;
+        Node* y = z->parent->parent->left;
         if (y && y->color == RED) {
           z->parent->color = BLACK;          // Case 4
           y->color = BLACK;                  // Case 4
           z->parent->parent->color = RED;    // Case 4
           z = z->parent->parent;             // Case 4
+          RBT_STAT(stats.recolors += 3);
         } else {
           if (z == z->parent->left) {
             z = z->parent;                   // Case 5
@@ -250,10 +488,12 @@ private:
           z->parent->color = BLACK;          // Case 6
           z->parent->parent->color = RED;    // Case 6
           leftRotate(z->parent->parent);  // Case 6
+          RBT_STAT(stats.recolors += 2);
         }
       }
     }
     root->color = BLACK; // Ensure the root is black // Case 0
+    RBT_STAT(stats.recolors++);
   }
 
   /**
@@ -261,83 +501,510 @@ private:
   *
   * This function ensures that the Red-Black Tree properties are maintained after deleting a node.
   * It applies a series of cases (1 to 4) to rebalance and recolor the tree appropriately.
+  * Null children count as black, so the parent of x is passed separately for the case where x is null.
   *
-  * @param x The node that might violate the Red-Black Tree properties after deletion.
+  * @param x The node that might violate the Red-Black Tree properties after deletion, may be null.
+  * @param xParent The parent of x.
   */
-  void deleteFixup(RBT::Node* x) {
-
-    if (x == nullptr || x->parent == nullptr) {
-      return; // undefined error
-    }
-    while (x != root && x->color == BLACK) {
-      if (x == x->parent->left) {
-        RBT::Node* w = x->parent->right;
-        if (w && w->color == RED) {
+  void deleteFixup(Node* x, Node* xParent) {
+    while (x != root && (x == nullptr || x->color == BLACK)) {
+      RBT_STAT(stats.deleteFixupIterations++);
+      if (x == xParent->left) {
+        Node* w = xParent->right;
+        if (w->color == RED) {
           w->color = BLACK;               // Case 1
-          x->parent->color = RED;         // Case 1
-          leftRotate(x->parent);        // Case 1
-          w = x->parent->right;           // Case 1
+          xParent->color = RED;           // Case 1
+          leftRotate(xParent);            // Case 1
+          w = xParent->right;             // Case 1
+          RBT_STAT(stats.recolors += 2);
         }
-        if (w->left && w->left->color == BLACK && w->right && w->right->color == BLACK) {
+        if ((w->left == nullptr || w->left->color == BLACK) && (w->right == nullptr || w->right->color == BLACK)) {
           w->color = RED;                 // Case 2
-          x = x->parent;                  // Case 2
+          x = xParent;                    // Case 2
+          xParent = x->parent;            // Case 2
+          RBT_STAT(stats.recolors++);
         } else {
-          if (w->right && w->right->color == BLACK) {
+          if (w->right == nullptr || w->right->color == BLACK) {
             w->left->color = BLACK;       // Case 3
             w->color = RED;               // Case 3
-            rightRotate(w);             // Case 3
-            w = x->parent->right;         // Case 3
+            rightRotate(w);               // Case 3
+            w = xParent->right;           // Case 3
+            RBT_STAT(stats.recolors += 2);
           }
-          w->color = x->parent->color;     // Case 4
-          x->parent->color = BLACK;        // Case 4
-          w->right->color = BLACK;         // Case 4
-          leftRotate(x->parent);         // Case 4
-          x = root;                        // Case 4
+          w->color = xParent->color;      // Case 4
+          xParent->color = BLACK;         // Case 4
+          w->right->color = BLACK;        // Case 4
+          leftRotate(xParent);            // Case 4
+          x = root;                       // Case 4
+          RBT_STAT(stats.recolors += 3);
         }
       } else { // Symmetric cases for right subtree
-        RBT::Node* w = x->parent->left;
-        if (w && w->color == RED) {
-          w->color = BLACK;                 // Case 1
-          x->parent->color = RED;           // Case 1
-          rightRotate(x->parent);         // Case 1
-          w = x->parent->left;              // Case 1
+        Node* w = xParent->left;
+        if (w->color == RED) {
+          w->color = BLACK;               // Case 1
+          xParent->color = RED;           // Case 1
+          rightRotate(xParent);           // Case 1
+          w = xParent->left;              // Case 1
+          RBT_STAT(stats.recolors += 2);
         }
-        if (w->right && w->right->color == BLACK && w->left && w->left->color == BLACK) {
-          w->color = RED;                   // Case 2
-          x = x->parent;                    // Case 2
+        if ((w->right == nullptr || w->right->color == BLACK) && (w->left == nullptr || w->left->color == BLACK)) {
+          w->color = RED;                 // Case 2
+          x = xParent;                    // Case 2
+          xParent = x->parent;            // Case 2
+          RBT_STAT(stats.recolors++);
         } else {
-          if (w->left && w->left->color == BLACK) {
-            w->right->color = BLACK;       // Case 3
-            w->color = RED;                // Case 3
-            leftRotate(w);               // Case 3
-            w = x->parent->left;           // Case 3
+          if (w->left == nullptr || w->left->color == BLACK) {
+            w->right->color = BLACK;      // Case 3
+            w->color = RED;               // Case 3
+            leftRotate(w);                // Case 3
+            w = xParent->left;            // Case 3
+            RBT_STAT(stats.recolors += 2);
           }
-          w->color = x->parent->color;      // Case 4
-          x->parent->color = BLACK;         // Case 4
-          w->left->color = BLACK;           // Case 4
-          rightRotate(x->parent);         // Case 4
-          x = root;                         // Case 4
+          w->color = xParent->color;      // Case 4
+          xParent->color = BLACK;         // Case 4
+          w->left->color = BLACK;         // Case 4
+          rightRotate(xParent);           // Case 4
+          x = root;                       // Case 4
+          RBT_STAT(stats.recolors += 3);
         }
       }
     }
     if (x != nullptr) {
         x->color = BLACK; // Ensure the root is black
+        RBT_STAT(stats.recolors++);
+    }
+  }
+
+  /**
+   * @brief Helper function to check whether the given node is red, null nodes are black.
+   * @param node The node to check.
+   * @return True if the node is red, otherwise false.
+   */
+  static bool isRed(Node *node) {
+    return node != nullptr && node->color == RED;
+  }
+
+  /**
+   * @brief Helper function to get the black height of a subtree, the number of black nodes on a path from its root down to null.
+   * @param node The root of the subtree.
+   * @return The black height, 0 for an empty subtree.
+   */
+  static int blackHeight(Node *node) {
+    int height = 0;
+    while (node != nullptr) {
+      height += node->color == BLACK;
+      node = node->left;
+    }
+    return height;
+  }
+
+  /**
+   * @brief Helper function to make the given node the detached root of left and right with the given color.
+   * @param left The new left subtree.
+   * @param node The new root.
+   * @param right The new right subtree.
+   * @param color The color of the new root.
+   * @return The new root.
+   */
+  static Node *link(Node *left, Node *node, Node *right, int color) {
+    node->left = left;
+    node->right = right;
+    node->parent = nullptr;
+    node->color = color;
+    if (left != nullptr)
+      left->parent = node;
+    if (right != nullptr)
+      right->parent = node;
+    return node;
+  }
+
+  /**
+   * @brief Helper function to detach the children of a node, so they can be used as standalone subtrees.
+   * @param node The node whose children are detached.
+   * @param left The detached left subtree.
+   * @param right The detached right subtree.
+   */
+  static void detach(Node *node, Node *&left, Node *&right) {
+    left = node->left;
+    right = node->right;
+    if (left != nullptr)
+      left->parent = nullptr;
+    if (right != nullptr)
+      right->parent = nullptr;
+  }
+
+  /**
+   * @brief Helper function to join left, the middle node and right when left is at least as black-high as right.
+   *
+   * Walks down the right spine of left to the first black node of the black height of right, hangs the middle
+   * node there in red and repairs a red-red violation with one rotation on the way back up.
+   *
+   * @param left The left subtree, all of its keys are not greater than the middle key.
+   * @param leftHeight The black height of left.
+   * @param middle The middle node.
+   * @param right The right subtree, with a black root, all of its keys are not less than the middle key.
+   * @param rightHeight The black height of right.
+   * @return The root of the joined subtree, which may be red with a red right child.
+   */
+  static Node *joinRight(Node *left, int leftHeight, Node *middle, Node *right, int rightHeight) {
+    if (!isRed(left) && leftHeight == rightHeight) {
+      return link(left, middle, right, RED);
+    }
+    Node *joined = joinRight(left->right, leftHeight - !isRed(left), middle, right, rightHeight);
+    left->right = joined;
+    joined->parent = left;
+    if (!isRed(left) && isRed(joined) && isRed(joined->right)) {
+      joined->right->color = BLACK;
+      left->right = joined->left; // Left rotation around left
+      if (joined->left != nullptr)
+        joined->left->parent = left;
+      joined->left = left;
+      left->parent = joined;
+      joined->parent = nullptr;
+      return joined;
+    }
+    return left;
+  }
+
+  /**
+   * @brief Helper function to join left, the middle node and right when right is at least as black-high as left, symmetric to joinRight.
+   * @param left The left subtree, with a black root, all of its keys are not greater than the middle key.
+   * @param leftHeight The black height of left.
+   * @param middle The middle node.
+   * @param right The right subtree, all of its keys are not less than the middle key.
+   * @param rightHeight The black height of right.
+   * @return The root of the joined subtree, which may be red with a red left child.
+   */
+  static Node *joinLeft(Node *left, int leftHeight, Node *middle, Node *right, int rightHeight) {
+    if (!isRed(right) && leftHeight == rightHeight) {
+      return link(left, middle, right, RED);
+    }
+    Node *joined = joinLeft(left, leftHeight, middle, right->left, rightHeight - !isRed(right));
+    right->left = joined;
+    joined->parent = right;
+    if (!isRed(right) && isRed(joined) && isRed(joined->left)) {
+      joined->left->color = BLACK;
+      right->left = joined->right; // Right rotation around right
+      if (joined->right != nullptr)
+        joined->right->parent = right;
+      joined->right = right;
+      right->parent = joined;
+      joined->parent = nullptr;
+      return joined;
+    }
+    return right;
+  }
+
+  /**
+   * @brief Helper function to join two detached subtrees with a middle node into one subtree in O(|leftHeight - rightHeight| + 1) time.
+   * @param left The left subtree, all of its keys are not greater than the middle key.
+   * @param leftHeight The black height of left.
+   * @param middle The middle node, its children and color are overwritten.
+   * @param right The right subtree, all of its keys are not less than the middle key.
+   * @param rightHeight The black height of right.
+   * @param height The black height of the joined subtree.
+   * @return The root of the joined subtree.
+   */
+  static Node *join(Node *left, int leftHeight, Node *middle, Node *right, int rightHeight, int &height) {
+    if (isRed(left)) { // Standalone roots can always be made black
+      left->color = BLACK;
+      leftHeight++;
+    }
+    if (isRed(right)) {
+      right->color = BLACK;
+      rightHeight++;
+    }
+
+    Node *joined;
+    if (leftHeight > rightHeight) {
+      joined = joinRight(left, leftHeight, middle, right, rightHeight);
+      height = leftHeight;
+      if (isRed(joined) && isRed(joined->right)) {
+        joined->color = BLACK;
+        height++;
+      }
+    } else if (rightHeight > leftHeight) {
+      joined = joinLeft(left, leftHeight, middle, right, rightHeight);
+      height = rightHeight;
+      if (isRed(joined) && isRed(joined->left)) {
+        joined->color = BLACK;
+        height++;
+      }
     } else {
-        return; //Undefined error
+      joined = link(left, middle, right, RED);
+      height = leftHeight;
     }
+    joined->parent = nullptr;
+    return joined;
   }
+
+  /**
+   * @brief Helper function to remove the last node of a detached subtree.
+   * @param node The root of the subtree.
+   * @param nodeHeight The black height of the subtree.
+   * @param last The removed node, the one with the largest key.
+   * @param height The black height of the remaining subtree.
+   * @return The root of the remaining subtree.
+   */
+  static Node *splitLast(Node *node, int nodeHeight, Node *&last, int &height) {
+    Node *left, *right;
+    detach(node, left, right);
+    int childHeight = nodeHeight - !isRed(node);
+    if (right == nullptr) {
+      last = node;
+      height = childHeight;
+      return left;
+    }
+    int restHeight;
+    Node *rest = splitLast(right, childHeight, last, restHeight);
+    return join(left, childHeight, node, rest, restHeight, height);
+  }
+
+  /**
+   * @brief Helper function to join two detached subtrees without a middle node, using the last node of left as the middle.
+   * @param left The left subtree, all of its keys are not greater than the keys of right.
+   * @param leftHeight The black height of left.
+   * @param right The right subtree.
+   * @param rightHeight The black height of right.
+   * @param height The black height of the joined subtree.
+   * @return The root of the joined subtree.
+   */
+  static Node *join2(Node *left, int leftHeight, Node *right, int rightHeight, int &height) {
+    if (left == nullptr) {
+      height = rightHeight;
+      return right;
+    }
+    Node *last;
+    int restHeight;
+    Node *rest = splitLast(left, leftHeight, last, restHeight);
+    return join(rest, restHeight, last, right, rightHeight, height);
+  }
+
+  /**
+   * @brief Helper function to split a detached subtree by a key in O(log n) time.
+   * @param node The root of the subtree.
+   * @param nodeHeight The black height of the subtree.
+   * @param key The key to split by.
+   * @param inclusive If true the keys equivalent to key go left, otherwise they go right.
+   * @param left The subtree of the smaller keys.
+   * @param leftHeight The black height of left.
+   * @param right The subtree of the larger keys.
+   * @param rightHeight The black height of right.
+   */
+  void splitHelper(Node *node, int nodeHeight, const Key &key, bool inclusive, Node *&left, int &leftHeight, Node *&right, int &rightHeight) {
+    if (node == nullptr) {
+      left = right = nullptr;
+      leftHeight = rightHeight = 0;
+      return;
+    }
+    Node *nodeLeft, *nodeRight;
+    detach(node, nodeLeft, nodeRight);
+    int childHeight = nodeHeight - !isRed(node);
+    bool goesLeft = inclusive ? !compare(key, node->data) : compare(node->data, key);
+    if (goesLeft) {
+      Node *middle;
+      int middleHeight;
+      splitHelper(nodeRight, childHeight, key, inclusive, middle, middleHeight, right, rightHeight);
+      left = join(nodeLeft, childHeight, node, middle, middleHeight, leftHeight);
+    } else {
+      Node *middle;
+      int middleHeight;
+      splitHelper(nodeLeft, childHeight, key, inclusive, left, leftHeight, middle, middleHeight);
+      right = join(middle, middleHeight, node, nodeRight, childHeight, rightHeight);
+    }
+  }
+
+  /**
+   * @brief Helper function to merge two detached subtrees, keeping every node of both.
+   * @param first The root of the first subtree, its root is used to split the second.
+   * @param firstHeight The black height of first.
+   * @param second The root of the second subtree.
+   * @param secondHeight The black height of second.
+   * @param threadDepth The number of levels below this one whose left halves are merged on separate threads.
+   * @param height The black height of the merged subtree.
+   * @return The root of the merged subtree.
+   */
+  Node *unionHelper(Node *first, int firstHeight, Node *second, int secondHeight, int threadDepth, int &height) {
+    if (first == nullptr) {
+      height = secondHeight;
+      return second;
+    }
+    if (second == nullptr) {
+      height = firstHeight;
+      return first;
+    }
+    Node *firstLeft, *firstRight, *secondLeft, *secondRight;
+    int secondLeftHeight, secondRightHeight;
+    detach(first, firstLeft, firstRight);
+    int childHeight = firstHeight - !isRed(first);
+    splitHelper(second, secondHeight, first->data, false, secondLeft, secondLeftHeight, secondRight, secondRightHeight);
+
+    Node *left, *right;
+    int leftHeight, rightHeight;
+    if (threadDepth > 0) { // The halves share no nodes, so they can be merged in parallel
+      std::thread leftWorker([&]() {
+        left = unionHelper(firstLeft, childHeight, secondLeft, secondLeftHeight, threadDepth - 1, leftHeight);
+      });
+      right = unionHelper(firstRight, childHeight, secondRight, secondRightHeight, threadDepth - 1, rightHeight);
+      leftWorker.join();
+    } else {
+      left = unionHelper(firstLeft, childHeight, secondLeft, secondLeftHeight, 0, leftHeight);
+      right = unionHelper(firstRight, childHeight, secondRight, secondRightHeight, 0, rightHeight);
+    }
+    return join(left, leftHeight, first, right, rightHeight, height);
+  }
+
+  /**
+   * @brief Helper function to keep the nodes of a detached subtree depending on whether their keys appear in another subtree.
+   *
+   * The keys of other lie strictly between low and high. Nodes of first equivalent to a bound are decided by the
+   * flag of that bound, any other node by splitting other at its key. Every node of other and every node of first
+   * that is not kept is freed.
+   *
+   * @param first The root of the subtree to be filtered.
+   * @param firstHeight The black height of first.
+   * @param other The root of the subtree whose keys are looked up.
+   * @param otherHeight The black height of other.
+   * @param low The lower bound of the keys of first, or null if there is none.
+   * @param lowPresent Whether the key low appears in the other tree.
+   * @param high The upper bound of the keys of first, or null if there is none.
+   * @param highPresent Whether the key high appears in the other tree.
+   * @param keepPresent True to keep the nodes whose key appears in other (intersection), false to keep the others (difference).
+   * @param threadDepth The number of levels below this one whose left halves are filtered on separate threads.
+   * @param height The black height of the filtered subtree.
+   * @return The root of the filtered subtree.
+   */
+  Node *filterHelper(Node *first, int firstHeight, Node *other, int otherHeight, const Key *low, bool lowPresent,
+                     const Key *high, bool highPresent, bool keepPresent, int threadDepth, int &height) {
+    if (first == nullptr) {
+      destroyTree(other);
+      height = 0;
+      return nullptr;
+    }
+    if (other == nullptr && !lowPresent && !highPresent) { // No key of first appears in other
+      if (keepPresent) {
+        destroyTree(first);
+        height = 0;
+        return nullptr;
+      }
+      height = firstHeight;
+      return first;
+    }
+    if (other == nullptr) { // Only the keys equivalent to a bound may appear, they are at the two ends of first
+      Node *lowPart = nullptr, *highPart = nullptr, *rest = first;
+      int lowHeight = 0, highHeight = 0, restHeight = firstHeight;
+      if (low != nullptr) {
+        splitHelper(rest, restHeight, *low, true, lowPart, lowHeight, rest, restHeight);
+      }
+      if (high != nullptr) {
+        splitHelper(rest, restHeight, *high, false, rest, restHeight, highPart, highHeight);
+      }
+      if (lowPresent != keepPresent) {
+        destroyTree(lowPart);
+        lowPart = nullptr;
+        lowHeight = 0;
+      }
+      if (keepPresent) { // The keys strictly between the bounds do not appear in other
+        destroyTree(rest);
+        rest = nullptr;
+        restHeight = 0;
+      }
+      if (highPresent != keepPresent) {
+        destroyTree(highPart);
+        highPart = nullptr;
+        highHeight = 0;
+      }
+      int joinedHeight;
+      Node *joined = join2(lowPart, lowHeight, rest, restHeight, joinedHeight);
+      return join2(joined, joinedHeight, highPart, highHeight, height);
+    }
+
+    Node *firstLeft, *firstRight;
+    detach(first, firstLeft, firstRight);
+    int childHeight = firstHeight - !isRed(first);
+    const Key &key = first->data;
+
+    bool present;
+    Node *otherLeft = nullptr, *otherRight = nullptr;
+    int otherLeftHeight = 0, otherRightHeight = 0;
+    if (low != nullptr && !compare(*low, key)) { // key is equivalent to low, first->left holds only such keys
+      present = lowPresent;
+      otherRight = other;
+      otherRightHeight = otherHeight;
+    } else if (high != nullptr && !compare(key, *high)) { // key is equivalent to high, first->right holds only such keys
+      present = highPresent;
+      otherLeft = other;
+      otherLeftHeight = otherHeight;
+    } else {
+      Node *rest, *equal;
+      int restHeight, equalHeight;
+      splitHelper(other, otherHeight, key, false, otherLeft, otherLeftHeight, rest, restHeight);
+      splitHelper(rest, restHeight, key, true, equal, equalHeight, otherRight, otherRightHeight);
+      present = equal != nullptr;
+      destroyTree(equal);
+    }
+
+    Node *left, *right;
+    int leftHeight, rightHeight;
+    if (threadDepth > 0) { // The halves share no nodes, so they can be filtered in parallel
+      std::thread leftWorker([&]() {
+        left = filterHelper(firstLeft, childHeight, otherLeft, otherLeftHeight, low, lowPresent, &key, present, keepPresent, threadDepth - 1, leftHeight);
+      });
+      right = filterHelper(firstRight, childHeight, otherRight, otherRightHeight, &key, present, high, highPresent, keepPresent, threadDepth - 1, rightHeight);
+      leftWorker.join();
+    } else {
+      left = filterHelper(firstLeft, childHeight, otherLeft, otherLeftHeight, low, lowPresent, &key, present, keepPresent, 0, leftHeight);
+      right = filterHelper(firstRight, childHeight, otherRight, otherRightHeight, &key, present, high, highPresent, keepPresent, 0, rightHeight);
+    }
+
+    if (present == keepPresent) {
+      return join(left, leftHeight, first, right, rightHeight, height);
+    }
+    destroyNode(first);
+    return join2(left, leftHeight, right, rightHeight, height);
+  }
+
+  /**
+   * @brief Helper function of intersectWith and differenceWith.
+   * @param other The tree whose keys are looked up, emptied by this call.
+   * @param keepPresent True to keep the nodes whose key appears in other, false to keep the others.
+   * @param threadDepth The number of top levels filtered in parallel.
+   */
+  void filter(BasicRedBlackTree &other, bool keepPresent, int threadDepth) {
+    if (&other == this) {
+      return;
+    }
+    RBT_STAT(long long nodesBefore = countNodes(root) + countNodes(other.root));
+    int height;
+    root = filterHelper(root, blackHeight(root), other.root, blackHeight(other.root), nullptr, false, nullptr, false, keepPresent, threadDepth, height);
+    other.root = nullptr;
+    if (root != nullptr)
+      root->color = BLACK;
+    RBT_STAT(stats.frees += nodesBefore - countNodes(root)); // Counted here as the nodes may be freed on several threads
+  }
+
+#ifdef RBT_STATS
+  /**
+   * @brief Adds a finished search to the search path length histogram, safe to call from concurrent readers.
+   * @param pathLength The number of nodes compared with the searched value.
+   */
+  void recordSearch(int pathLength) {
+    stats.searches.fetch_add(1, std::memory_order_relaxed);
+    stats.searchPathLengths[std::min(pathLength, 63)].fetch_add(1, std::memory_order_relaxed);
+  }
+#endif
 public:
   /**
    * @brief Constructor to initialize the root node to null.
    */
-  RedBlackTree() {
+  BasicRedBlackTree() {
     root = nullptr;
   }
 
   /**
    * @brief Destructor to free the memory allocated for nodes in the Red-Black Tree.
    */
-  ~RedBlackTree() {
+  ~BasicRedBlackTree() {
     // Call a helper function to recursively delete nodes starting from the root
     destroyTree(root);
   }
@@ -347,7 +1014,7 @@ public:
    * @param orderedData The array to store the data in.
    * @param startIndex The starting index of the array to store the data in, if given as 0 it simply starts the array in 0th index.
    */
-  void preorder(std::pair<std::string, int> orderedData[], int startIndex) {
+  void preorder(std::pair<Value, Key> orderedData[], int startIndex) {
     int index = startIndex;
     preorderHelper(root, orderedData, index);
   }
@@ -357,7 +1024,7 @@ public:
    * @param orderedData The array to store the data in.
    * @param startIndex The starting index of the array to store the data in, if given as 0 it simply starts the array in 0th index.
    */
-  void inorder(std::pair<std::string, int> orderedData[], int startIndex) {
+  void inorder(std::pair<Value, Key> orderedData[], int startIndex) {
     int index = startIndex;
     inorderHelper(root, orderedData, index);
   }
@@ -367,7 +1034,7 @@ public:
    * @param orderedData The array to store the data in.
    * @param startIndex The starting index of the array to store the data in, if given as 0 it simply starts the array in 0th index.
    */
-  void postorder(std::pair<std::string, int> orderedData[], int startIndex) {
+  void postorder(std::pair<Value, Key> orderedData[], int startIndex) {
     int index = startIndex;
     postorderHelper(root, orderedData, index);
   }
@@ -377,16 +1044,114 @@ public:
    * @param value The value to search for.
    * @return The node with the given value, if found. Otherwise, returns null.
    */
-  RBT::Node* searchTree(int value) {
-    RBT::Node* current = root;
-    while (current != nullptr && value != current->data) {
-      if (value < current->data) {
+  Node* searchTree(const Key& value) {
+    return find(value);
+  }
+
+  /**
+   * @brief Function to search the tree for a value of another type, only available with a transparent comparator.
+   * @param value The value to search for, e.g. a std::string_view for std::string keys.
+   * @return The node with an equivalent key, if found. Otherwise, returns null.
+   */
+  template <class K, class C = Compare, class = typename C::is_transparent>
+  Node* searchTree(const K& value) {
+    return find(value);
+  }
+
+  /**
+  * @brief Function to search the tree for many values at once, hiding the memory latency of each step.
+  *
+  * The keys are processed in groups of groupSize. Within a group every traversal takes one step per
+  * round and prefetches the node it moves to, so the cache misses of one traversal overlap with the
+  * comparisons of the others instead of stalling the whole lookup (group prefetching).
+  *
+  * @param keys The values to search for.
+  * @param n The number of values.
+  * @param out The array to store the found nodes in, out[i] is the result of searchTree(keys[i]).
+  * @param groupSize The number of traversals interleaved together, at most 64.
+  */
+  void searchBatch(const Key* keys, size_t n, Node** out, size_t groupSize = 16) {
+    const size_t maxGroupSize = 64;
+    groupSize = std::max<size_t>(1, std::min(groupSize, maxGroupSize));
+    Node* current[maxGroupSize];
+
+    for (size_t head = 0; head < n; head += groupSize) {
+      size_t count = std::min(groupSize, n - head);
+      for (size_t i = 0; i < count; i++) {
+        current[i] = root;
+      }
+
+      size_t active = count;
+      while (active > 0) { // One step of every unfinished traversal per round
+        active = 0;
+        for (size_t i = 0; i < count; i++) {
+          Node* node = current[i];
+          if (node == nullptr) {
+            continue; // This traversal is finished
+          }
+          if (compare(keys[head + i], node->data)) {
+            node = node->left;
+          } else if (compare(node->data, keys[head + i])) {
+            node = node->right;
+          } else {
+            continue; // Found, this traversal is finished
+          }
+          if (node != nullptr) {
+            __builtin_prefetch(node);
+            active++;
+          }
+          current[i] = node;
+        }
+      }
+
+      for (size_t i = 0; i < count; i++) {
+        out[head + i] = current[i];
+      }
+    }
+  }
+
+  /**
+  * @brief Function to search the tree for the city with the given population and name.
+  *
+  * Cities with equal populations are kept in insertion order, so the search first descends to the
+  * leftmost node with the given population and then walks the successors until the name matches.
+  *
+  * @param value The population to search for.
+  * @param name The city name to search for.
+  * @return The node with the given population and name, if found. Otherwise, returns null.
+  */
+  Node* searchTree(const Key& value, const Value& name) {
+    Node* first = lowerBound(value); // Leftmost node with the given value, if there is one
+    while (first != nullptr && !compare(value, first->data)) {
+      if (first->name == name) {
+        return first;
+      }
+      first = successor(first);
+    }
+    return nullptr;
+  }
+
+  /**
+  * @brief Function to find the first node whose value is not less than the given value.
+  *
+  * Together with successor this answers range queries: start from lowerBound(low) and walk the
+  * successors while the value does not exceed the upper end of the range.
+  *
+  * @param value The lower end of the range.
+  * @return The leftmost node with a value greater than or equal to the given value, or nullptr if there is none.
+  */
+  Node* lowerBound(const Key& value) {
+    Node* current = root;
+    Node* candidate = nullptr;
+    while (current != nullptr) {
+      if (!compare(current->data, value)) {
+        candidate = current;
         current = current->left;
       } else {
         current = current->right;
       }
     }
-    return current;
+    return candidate;
   }
 
   /**
@@ -398,7 +1163,7 @@ public:
   * @param node The node for which to find the successor.
   * @return A pointer to the successor node, or nullptr if the node is not found.
   */
-  RBT::Node* successor(RBT::Node* node) {
+  Node* successor(Node* node) {
       if (node == nullptr) {
           return nullptr; // Node with the given value not found
       }
@@ -409,7 +1174,7 @@ public:
       }
 
       // If the node does not have a right subtree
-      RBT::Node* ancestor = node->parent;
+      Node* ancestor = node->parent;
 
       while (ancestor != nullptr && node == ancestor->right) {
           node = ancestor;
@@ -429,7 +1194,7 @@ public:
   * @param node The node for which to find the predecessor.
   * @return A pointer to the predecessor node, or nullptr if the node is not found.
   */
-  RBT::Node* predecessor(RBT::Node* node) {
+  Node* predecessor(Node* node) {
       if (node == nullptr) {
           return nullptr; // Node with the given value not found
       }
@@ -440,10 +1205,10 @@ public:
       }
 
       // If the node does not have a left subtree
-      RBT::Node* predecessor = nullptr;
+      Node* predecessor = nullptr;
 
       while (node->parent != nullptr) {
-          if (node->data > node->parent->data) {
+          if (node == node->parent->right) {
               predecessor = node->parent;
               break;
           }
@@ -457,27 +1222,31 @@ public:
   * @brief Inserts a node into the Red-Black Tree (RBT) and performs fixup operations.
   *
   * This function inserts a new node with the given name and data into the Red-Black Tree.
+  * A node with a data value equal to an existing one goes to its right, and rotations preserve the
+  * inorder sequence, so equal populations always stay in insertion order.
   * It then applies fixup operations to maintain the Red-Black Tree properties, including balancing
   * and recoloring as needed.
   *
   * @param name The name of the node to be inserted.
   * @param data The data value associated with the node to be inserted.
+  * @return The inserted node, which can later be passed to deleteNode.
   */
-  void insert(std::string name, int data) {
-    RBT::Node* z = new RBT::Node;
+  Node* insert(const Value& name, const Key& data) {
+    Node* z = createNode();
     z->name = name;
     z->data = data;
     z->left = nullptr;
     z->right = nullptr;
     z->color = RED; // New node is always red
+    RBT_STAT(stats.allocations++);
 
-    RBT::Node* y = nullptr;
-    RBT::Node* x = root;
+    Node* y = nullptr;
+    Node* x = root;
 
     // Traverse the tree to find the appropriate position for the new node
     while (x != nullptr) {
       y = x;
-      if (z->data < x->data)
+      if (compare(z->data, x->data))
         x = x->left;
       else
         x = x->right;
@@ -488,19 +1257,124 @@ public:
     // Update the parent's left or right pointer based on the comparison
     if (y == nullptr)
       root = z;
-    else if (z->data < y->data)
+    else if (compare(z->data, y->data))
       y->left = z;
     else
       y->right = z;
 
     insertFixup(z); // Fixup the Red-Black Tree after insertion
+    return z;
   }
 
   /**
-  * @brief Deletes a node with the given data from the Red-Black Tree (RBT).
+  * @brief Builds the Red-Black Tree (RBT) from an array that is already sorted by population.
+  *
+  * Any existing nodes are freed first. Each element is allocated exactly once and linked in place,
+  * so the build takes O(n) time without any rotation or fixup, and the resulting tree has the
+  * minimum possible height floor(log2(n)).
+  *
+  * @param sortedData The array sorted in ascending order of population, e.g. the output of QuickSort or HeapSort.
+  * @param length The number of elements in the array.
+  * @param threadDepth The number of top levels whose subtrees are built in parallel, 2^threadDepth threads are used. 0 builds serially.
+  */
+  void buildFromSorted(const std::pair<Value, Key> sortedData[], int length, int threadDepth = 0) {
+    RBT_STAT(stats.frees += countNodes(root));
+    destroyTree(root);
+
+    int redDepth = 0; // Depth of the deepest level, floor(log2(length))
+    while ((2 << redDepth) <= length) {
+      redDepth++;
+    }
+    root = buildHelper(sortedData, 0, length - 1, nullptr, 0, redDepth, threadDepth);
+    RBT_STAT(stats.allocations += length); // Counted here as the subtrees may be built on several threads
+  }
+
+  /**
+  * @brief Moves all nodes of other to the end of this tree, leaving other empty.
+  *
+  * When every key of other is not less than every key of this tree, the trees are joined in O(log n) time
+  * without visiting the nodes. Otherwise the trees are merged with unionWith.
   *
-  * This function deletes the node with the specified data from the Red-Black Tree. The deletion operation
-  * considers three cases based on the number of children the node to be deleted has:
+  * @param other The tree to be appended.
+  */
+  void join(BasicRedBlackTree &other) {
+    if (&other == this || other.root == nullptr) {
+      return;
+    }
+    if (root != nullptr && compare(findMin(other.root)->data, findMax(root)->data)) {
+      unionWith(other); // The key ranges overlap
+      return;
+    }
+    int height;
+    root = join2(root, blackHeight(root), other.root, blackHeight(other.root), height);
+    other.root = nullptr;
+    if (root != nullptr)
+      root->color = BLACK;
+  }
+
+  /**
+  * @brief Splits the tree by a key in O(log n) time: this tree keeps the smaller keys and greater receives the rest.
+  * @param key The key to split by, nodes with an equivalent key are moved to greater.
+  * @param greater The tree that receives the nodes with keys not less than key, its previous nodes are freed.
+  */
+  void split(const Key &key, BasicRedBlackTree &greater) {
+    if (&greater == this) {
+      return;
+    }
+    RBT_STAT(stats.frees += greater.countNodes(greater.root));
+    greater.destroyTree(greater.root);
+    int leftHeight, rightHeight;
+    splitHelper(root, blackHeight(root), key, false, root, leftHeight, greater.root, rightHeight);
+    if (root != nullptr)
+      root->color = BLACK;
+    if (greater.root != nullptr)
+      greater.root->color = BLACK;
+  }
+
+  /**
+  * @brief Moves all nodes of other into this tree, leaving other empty.
+  *
+  * Cities with equal populations are all kept, as in a multiset. The root of this tree splits other,
+  * the two halves are merged recursively and joined again, which takes O(m log(n/m + 1)) time for
+  * trees of m <= n nodes instead of the O(m log n) of inserting one by one. No node is allocated.
+  *
+  * @param other The tree to be merged in.
+  * @param threadDepth The number of top levels whose halves are merged in parallel, 2^threadDepth threads are used. 0 merges serially.
+  */
+  void unionWith(BasicRedBlackTree &other, int threadDepth = 0) {
+    if (&other == this) {
+      return;
+    }
+    int height;
+    root = unionHelper(root, blackHeight(root), other.root, blackHeight(other.root), threadDepth, height);
+    other.root = nullptr;
+    if (root != nullptr)
+      root->color = BLACK;
+  }
+
+  /**
+  * @brief Keeps only the nodes whose key also appears in other, in O(m log(n/m + 1)) time. Other is emptied and all removed nodes are freed.
+  * @param other The tree whose keys are kept.
+  * @param threadDepth The number of top levels whose halves are filtered in parallel, 2^threadDepth threads are used. 0 filters serially.
+  */
+  void intersectWith(BasicRedBlackTree &other, int threadDepth = 0) {
+    filter(other, true, threadDepth);
+  }
+
+  /**
+  * @brief Removes the nodes whose key appears in other, in O(m log(n/m + 1)) time. Other is emptied and all removed nodes are freed.
+  * @param other The tree whose keys are removed.
+  * @param threadDepth The number of top levels whose halves are filtered in parallel, 2^threadDepth threads are used. 0 filters serially.
+  */
+  void differenceWith(BasicRedBlackTree &other, int threadDepth = 0) {
+    filter(other, false, threadDepth);
+  }
+
+  /**
+  * @brief Deletes the given node from the Red-Black Tree (RBT).
+  *
+  * This function deletes the given node from the Red-Black Tree without searching for it again. The deletion
+  * operation considers three cases based on the number of children the node to be deleted has:
   * - Case 1: Node has 0 children (leaf node)
   * - Case 2: Node has 1 child
   * - Case 3: Node has 2 children
@@ -508,59 +1382,77 @@ public:
   * After deletion, the function ensures the Red-Black Tree properties are maintained and performs
   * fixup operations as necessary.
   *
-  * @param data The data value of the node to be deleted.
+  * @param nodeToDelete The node to be deleted, e.g. the result of insert or searchTree. It is freed by this call.
   */
-  void deleteNode(int data) {
-    RBT::Node* nodeToDelete = searchTree(data); // Find the node to delete
-
+  void deleteNode(Node* nodeToDelete) {
     if (nodeToDelete == nullptr) {
-      return; // Node with the given value not found
+      return; // Nothing to delete
     }
-    RBT::Node* x = nullptr;
-    RBT::Node* y = nodeToDelete;
+    Node* x = nullptr;
+    Node* xParent = nullptr; // Parent of x, kept separately as x can be null
+    Node* y = nodeToDelete;
     int yOriginalColor = y->color;
 
     if (nodeToDelete->left == nullptr) { // cases when current node has 0 child, it simply satisfy the first if then replaced with nullptr(nodeToDelete->right)
       x = nodeToDelete->right;           // cases when current node has 1 child, transplant the child to the current node
+      xParent = nodeToDelete->parent;
 
       transplant(nodeToDelete, nodeToDelete->right);
     } else if (nodeToDelete->right == nullptr) {
       x = nodeToDelete->left;
+      xParent = nodeToDelete->parent;
 
       transplant(nodeToDelete, nodeToDelete->left);
     } else {  // cases when current node has 2 children
-        if (nodeToDelete != nullptr && nodeToDelete->right != nullptr) {
-            y = findMin(nodeToDelete->right); // Find the successor node (minimum value in the right subtree)
-            yOriginalColor = y->color;
-            x = y->right; // Get the right child of the successor node
-
-            if (y->parent == nodeToDelete) {  // Case where the successor node is the right child of the node to be deleted
-                if (x != nullptr) {
-                    x->parent = y;
-                }
-            } else {                          // Case where the successor node is deeper in the right subtree
-                transplant(y, y->right);
-                if (nodeToDelete->right != nullptr) {
-                    y->right = nodeToDelete->right;
-                    y->right->parent = y;
-                }
-            }
-            transplant(nodeToDelete, y);     // Replace the node to be deleted with its successor
-            if (nodeToDelete->left != nullptr) {  // Update left child of the successor with the left child of the node to be deleted
-                y->left = nodeToDelete->left;
-                y->left->parent = y;
-            }
-            y->color = nodeToDelete->color;       // Maintain the color of the successor node
+      y = findMin(nodeToDelete->right); // Find the successor node (minimum value in the right subtree)
+      yOriginalColor = y->color;
+      x = y->right; // Get the right child of the successor node
+
+      if (y->parent == nodeToDelete) {  // Case where the successor node is the right child of the node to be deleted
+        xParent = y;
+        if (x != nullptr) {
+          x->parent = y;
         }
+      } else {                          // Case where the successor node is deeper in the right subtree
+        xParent = y->parent;
+        transplant(y, y->right);
+        y->right = nodeToDelete->right;
+        y->right->parent = y;
+      }
+      transplant(nodeToDelete, y);      // Replace the node to be deleted with its successor
+      y->left = nodeToDelete->left;     // Update left child of the successor with the left child of the node to be deleted
+      y->left->parent = y;
+      y->color = nodeToDelete->color;   // Maintain the color of the successor node
     }
 
-    delete nodeToDelete; // Delete the node to be deleted
+    destroyNode(nodeToDelete); // Delete the node to be deleted
+    RBT_STAT(stats.frees++);
 
     if (yOriginalColor == BLACK) {
-      deleteFixup(x);
+      deleteFixup(x, xParent);
     }
   }
 
+  /**
+  * @brief Deletes a node with the given data from the Red-Black Tree (RBT).
+  *
+  * If several cities share the population, the one found first by searchTree is deleted.
+  *
+  * @param data The data value of the node to be deleted.
+  */
+  void deleteNode(const Key& data) {
+    deleteNode(searchTree(data)); // Find the node to delete
+  }
+
+  /**
+  * @brief Deletes the city with the given population and name from the Red-Black Tree (RBT).
+  * @param data The data value of the node to be deleted.
+  * @param name The city name of the node to be deleted.
+  */
+  void deleteNode(const Key& data, const Value& name) {
+    deleteNode(searchTree(data, name));
+  }
+
   /**
    * @brief Function to get the height of the tree.
    * @return The height of the tree.
@@ -573,7 +1465,7 @@ public:
   * @brief Gets the node with the maximum value in the Binary Search Tree (BST).
   * @return The node with the maximum value, or nullptr if the tree is empty.
   */
-  RBT::Node *getMaximum() {
+  Node *getMaximum() {
     if (root == nullptr) {
       return nullptr; // Tree is empty
     }
@@ -584,7 +1476,7 @@ public:
   * @brief Gets the node with the minimum value in the Binary Search Tree (BST).
   * @return The node with the minimum value, or nullptr if the tree is empty.
   */
-  RBT::Node *getMinimum() {
+  Node *getMinimum() {
     if (root == nullptr) {
       return nullptr; // Tree is empty
     }
@@ -599,4 +1491,40 @@ public:
     return countNodes(root);
   }
 
-}; // End of RedBlackTree class
\ No newline at end of file
+#ifdef RBT_STATS
+  /**
+  * @brief Gets the counters collected since the tree was created, only available with RBT_STATS.
+  * @return The statistics of the tree.
+  */
+  const RBT::Stats &getStats() const {
+    return stats;
+  }
+
+  /**
+  * @brief Writes the counters in a readable form, e.g. into stats_popN.txt next to log_popN.txt.
+  * @param out The stream to write to.
+  */
+  void dumpStats(std::ostream &out) const {
+    out << "Rotations: " << stats.rotations << std::endl;
+    out << "Recolors: " << stats.recolors << std::endl;
+    out << "Insert fixup iterations: " << stats.insertFixupIterations << std::endl;
+    out << "Delete fixup iterations: " << stats.deleteFixupIterations << std::endl;
+    out << "Allocations: " << stats.allocations << std::endl;
+    out << "Frees: " << stats.frees << std::endl;
+    out << "Searches: " << stats.searches.load() << std::endl;
+    out << "Search path lengths (nodes compared: searches):" << std::endl;
+    for (int length = 0; length < 64; length++) {
+      long long searches = stats.searchPathLengths[length].load();
+      if (searches != 0) {
+        out << length << (length == 63 ? "+" : "") << ": " << searches << std::endl;
+      }
+    }
+  }
+#endif
+
+}; // End of BasicRedBlackTree class
+
+/**
+ * @brief The Red-Black Tree of cities keyed by population, as used by main.cpp.
+ */
+typedef BasicRedBlackTree<int, std::string> RedBlackTree;
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include "rbt.cpp"
+#include "bst.cpp"
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <malloc.h>
+
+/**
+ * @brief One operation of a workload trace.
+ *
+ * The operation letters are the ones used in trace files, one operation per line:
+ * 'i' insert, 's' searchTree, 'd' deleteNode, 'n' successor of the found node and 'r' range query.
+ * Range queries carry a second value, the upper end of the range, e.g. "r 1000 20000".
+ */
+struct Operation {
+  char type;
+  int key;
+  int high; // Upper end of the range, only used by 'r'
+};
+
+/**
+ * @brief Reads the cities and populations from the given file in the same way as main.cpp.
+ * @param inputFilename The name of the input file.
+ * @param data The array to store the (city, population) pairs in.
+ * @return True if the file is read, otherwise false.
+ */
+bool readPopulation(const char *inputFilename, std::vector<std::pair<std::string, int>> &data) {
+    std::ifstream file(inputFilename);
+    if (!file) {
+        std::cerr << "Error opening the file." << std::endl;
+        return false;
+    }
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t pos = line.find(';');
+        if (pos != std::string::npos) {
+            std::string city = line.substr(0, pos);
+            for (size_t i = 0; i < city.length(); i++) {
+                if (isalpha(city[i]) == false && city[i] != ' ' && city[i] != '\'') {
+                    // if the character is not a letter, space or apostrophe, remove it
+                    city.erase(i,1);
+                    i--;
+                }
+            }
+            data.push_back(std::make_pair(city, stoi(line.substr(pos + 1))));
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Reads a recorded trace, one operation per line.
+ * @param traceFilename The name of the trace file.
+ * @param trace The array to store the operations in.
+ * @return True if the file is read, otherwise false.
+ */
+bool readTrace(const char *traceFilename, std::vector<Operation> &trace) {
+    std::ifstream file(traceFilename);
+    if (!file) {
+        std::cerr << "Error opening the trace file." << std::endl;
+        return false;
+    }
+
+    Operation operation;
+    while (file >> operation.type >> operation.key) {
+        operation.high = operation.key;
+        if (operation.type == 'r') {
+            file >> operation.high;
+        }
+        trace.push_back(operation);
+    }
+    return true;
+}
+
+/**
+ * @brief Writes the trace in the format read by readTrace, so a generated workload can be replayed later.
+ * @param traceFilename The name of the trace file.
+ * @param trace The operations to write.
+ */
+void writeTrace(const char *traceFilename, const std::vector<Operation> &trace) {
+    std::ofstream file(traceFilename);
+    for (const Operation &operation : trace) {
+        file << operation.type << ' ' << operation.key;
+        if (operation.type == 'r') {
+            file << ' ' << operation.high;
+        }
+        file << '\n';
+    }
+}
+
+/**
+ * @brief Generates a trace of 50% search, 20% insert, 10% delete, 10% successor and 10% range operations.
+ *
+ * Keys are populations taken from the input rows. With the uniform distribution every row is equally
+ * likely; with the Zipfian distribution (s = 0.99) the row of rank k is chosen with probability
+ * proportional to 1 / k^s, where the ranks are a random permutation of the rows.
+ *
+ * @param data The (city, population) pairs of the input file.
+ * @param zipf True for Zipfian keys, false for uniform keys.
+ * @param operationCount The number of operations to generate.
+ * @param trace The array to store the operations in.
+ */
+void generateTrace(const std::vector<std::pair<std::string, int>> &data, bool zipf, int operationCount, std::vector<Operation> &trace) {
+    std::mt19937 generator(335);
+    int rows = data.size();
+
+    std::vector<int> ranked(rows); // ranked[k] is the row of rank k
+    for (int i = 0; i < rows; i++) {
+        ranked[i] = i;
+    }
+    std::shuffle(ranked.begin(), ranked.end(), generator);
+
+    std::vector<double> cumulative; // cumulative Zipf weights of the ranks, searched with a random number
+    if (zipf) {
+        cumulative.resize(rows);
+        double sum = 0;
+        for (int k = 0; k < rows; k++) {
+            sum += 1.0 / std::pow(k + 1, 0.99);
+            cumulative[k] = sum;
+        }
+    }
+    std::uniform_int_distribution<int> uniform(0, rows - 1);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    auto pickKey = [&]() {
+        int rank = uniform(generator);
+        if (zipf) {
+            double target = unit(generator) * cumulative.back();
+            rank = std::min<int>(rows - 1, std::lower_bound(cumulative.begin(), cumulative.end(), target) - cumulative.begin());
+        }
+        return data[ranked[rank]].second;
+    };
+
+    for (int i = 0; i < operationCount; i++) {
+        int roll = generator() % 10;
+        Operation operation;
+        operation.type = roll < 5 ? 's' : roll < 7 ? 'i' : roll < 8 ? 'd' : roll < 9 ? 'n' : 'r';
+        operation.key = pickKey();
+        operation.high = operation.key;
+        if (operation.type == 'r') {
+            operation.high = operation.key + 1000; // a narrow band of neighbouring populations
+        }
+        trace.push_back(operation);
+    }
+}
+
+/**
+ * @brief Gets the number of heap bytes currently allocated by the program, glibc only.
+ * @return The allocated bytes.
+ */
+long long heapInUse() {
+    struct mallinfo2 info = mallinfo2();
+    return info.uordblks + info.hblkhd; // small blocks + mmap'ed blocks
+}
+
+/**
+ * @brief Gets the number of rotations of a Red-Black Tree, only counted when built with -DRBT_STATS.
+ * @param tree The tree.
+ * @return The number of rotations performed so far, or -1 without RBT_STATS.
+ */
+#ifdef RBT_STATS
+long long rotationsOf(RedBlackTree &tree) {
+    return tree.getStats().rotations;
+}
+#else
+long long rotationsOf(RedBlackTree &) {
+    return -1;
+}
+#endif
+
+/**
+ * @brief Gets the number of rotations of a Binary Search Tree, which never rotates.
+ * @return 0.
+ */
+long long rotationsOf(BinarySearchTree &) {
+    return 0;
+}
+
+/**
+ * @brief Loads the input rows into a tree and replays the trace on it, timing every operation.
+ *
+ * Prints the throughput, the p50 and p99 latencies, the rotations per operation and the heap bytes held by the tree
+ * at the end of the replay. The rotations of the Red-Black Tree are printed as n/a unless built with -DRBT_STATS.
+ *
+ * @param label The name of the tree engine.
+ * @param data The (city, population) pairs to preload.
+ * @param trace The operations to replay.
+ */
+template <class Tree> void replay(const std::string &label, const std::vector<std::pair<std::string, int>> &data, const std::vector<Operation> &trace) {
+    std::vector<long long> latencies(trace.size());
+    long long heapBefore = heapInUse();
+    Tree tree;
+    for (const std::pair<std::string, int> &row : data) {
+        tree.insert(row.first, row.second);
+    }
+    long long rotationsBefore = rotationsOf(tree);
+
+    long long checksum = 0; // keeps the queries from being optimized away
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < trace.size(); i++) {
+        const Operation &operation = trace[i];
+        auto operationStart = std::chrono::steady_clock::now();
+        switch (operation.type) {
+        case 'i':
+            tree.insert("Replay", operation.key);
+            break;
+        case 's': {
+            auto node = tree.searchTree(operation.key);
+            checksum += node ? node->data : 0;
+            break;
+        }
+        case 'd':
+            tree.deleteNode(operation.key);
+            break;
+        case 'n': {
+            auto node = tree.successor(tree.searchTree(operation.key));
+            checksum += node ? node->data : 0;
+            break;
+        }
+        case 'r':
+            for (auto node = tree.lowerBound(operation.key); node != nullptr && node->data <= operation.high; node = tree.successor(node)) {
+                checksum++;
+            }
+            break;
+        default:
+            break;
+        }
+        latencies[i] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - operationStart).count();
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    long long rotations = rotationsOf(tree) - rotationsBefore;
+    long long treeBytes = heapInUse() - heapBefore;
+
+    std::sort(latencies.begin(), latencies.end());
+    size_t operations = std::max<size_t>(1, trace.size());
+    double perSecond = operations * 1e9 / std::max<long long>(1, duration.count());
+    std::cout << label << ": " << static_cast<long long>(perSecond) << " ops/s"
+              << ", p50 " << latencies[(operations - 1) / 2] << " ns"
+              << ", p99 " << latencies[(operations - 1) * 99 / 100] << " ns";
+    if (rotationsBefore < 0) { // Not counted without RBT_STATS
+        std::cout << ", n/a rotations/op";
+    } else {
+        std::cout << ", " << static_cast<double>(rotations) / operations << " rotations/op";
+    }
+    std::cout << ", " << treeBytes << " bytes for " << tree.getTotalNodes() << " nodes"
+              << " (checksum " << checksum << ")" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 3 || argc > 5) {
+        std::cerr << "Usage: " << argv[0] << " <input_filename> <uniform|zipf|trace_filename> [operation_count] [save_trace_filename]" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::pair<std::string, int>> data;
+    if (!readPopulation(argv[1], data) || data.empty()) {
+        return 1;
+    }
+
+    std::string source = argv[2];
+    std::vector<Operation> trace;
+    if (source == "uniform" || source == "zipf") {
+        int operationCount = argc >= 4 ? std::stoi(argv[3]) : 1000000;
+        generateTrace(data, source == "zipf", operationCount, trace);
+        if (argc == 5) {
+            writeTrace(argv[4], trace);
+        }
+    } else if (!readTrace(argv[2], trace)) {
+        return 1;
+    }
+    if (trace.empty()) {
+        std::cerr << "The trace is empty." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Rows: " << data.size() << ", operations: " << trace.size() << " (" << source << ")" << std::endl;
+    replay<RedBlackTree>("RBT", data, trace);
+    replay<BinarySearchTree>("BST", data, trace);
+    return 0;
+}
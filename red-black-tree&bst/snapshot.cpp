@@ -0,0 +1,324 @@
+// Implementing flat Red-Black Tree snapshots with mmap reload in C++
+// rbt.cpp must be included before this file
+
+/**
+  BLG335E - Analysis of Algorithms I - Project 3
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Structs of the snapshot file format inside a namespace.
+ *
+ * A snapshot is a header followed by three sections, all in the byte order of the machine that wrote it:
+ * - nodes: one Node per tree node, in inorder, so node i is the i-th smallest population;
+ * - colors: one bit per node, bit i % 8 of byte i / 8, set for RED;
+ * - names: the city names of the nodes concatenated in inorder, without separators.
+ * Children are node indices instead of pointers, so the file is used as it is after mapping it.
+ */
+namespace SNAPSHOT {
+  const uint32_t NIL = 0xFFFFFFFF; // Index of a missing child
+
+  struct Header {
+    char magic[4];        // "RBT1"
+    uint32_t nodeCount;   // Number of nodes
+    uint32_t root;        // Index of the root, NIL for an empty tree
+    uint32_t reserved;    // Keeps the sections 8-byte aligned
+    uint64_t colorsOffset; // File offset of the colors section
+    uint64_t namesOffset;  // File offset of the names section
+    uint64_t fileSize;     // Total size of the file
+  };
+
+  struct Node {
+    int32_t data;         // Population
+    uint32_t left;        // Index of the left child or NIL
+    uint32_t right;       // Index of the right child or NIL
+    uint32_t nameOffset;  // Offset of the name in the names section, the name ends where the next one starts
+  };
+}
+
+/**
+ * @brief Writes the given tree into a snapshot file that can be loaded with RedBlackTreeSnapshot.
+ * @param tree The tree to be written.
+ * @param filename The name of the snapshot file.
+ * @return True if the file is written, otherwise false.
+ */
+bool writeSnapshot(RedBlackTree &tree, const char *filename) {
+  std::vector<RBT::Node *> inorderNodes;
+  std::unordered_map<const RBT::Node *, uint32_t> indexOf;
+  for (RBT::Node *node = tree.getMinimum(); node != nullptr; node = tree.successor(node)) {
+    indexOf[node] = inorderNodes.size();
+    inorderNodes.push_back(node);
+  }
+  if (inorderNodes.size() >= SNAPSHOT::NIL) {
+    std::cerr << "Too many nodes for a snapshot." << std::endl;
+    return false;
+  }
+  uint32_t nodeCount = inorderNodes.size();
+  auto indexOfChild = [&](const RBT::Node *child) {
+    return child != nullptr ? indexOf[child] : SNAPSHOT::NIL;
+  };
+
+  std::vector<SNAPSHOT::Node> nodes(nodeCount);
+  std::vector<unsigned char> colors((nodeCount + 7) / 8, 0);
+  std::string names;
+  uint32_t root = SNAPSHOT::NIL;
+  for (uint32_t i = 0; i < nodeCount; i++) {
+    const RBT::Node *node = inorderNodes[i];
+    nodes[i].data = node->data;
+    nodes[i].left = indexOfChild(node->left);
+    nodes[i].right = indexOfChild(node->right);
+    nodes[i].nameOffset = names.size();
+    names += node->name;
+    if (node->color == RED) {
+      colors[i / 8] |= 1 << (i % 8);
+    }
+    if (node->parent == nullptr) {
+      root = i;
+    }
+  }
+  if (names.size() > UINT32_MAX) { // nameOffset and the name lengths are 32-bit
+    std::cerr << "City names too large for a snapshot." << std::endl;
+    return false;
+  }
+
+  SNAPSHOT::Header header;
+  std::memcpy(header.magic, "RBT1", 4);
+  header.nodeCount = nodeCount;
+  header.root = root;
+  header.reserved = 0;
+  header.colorsOffset = sizeof(SNAPSHOT::Header) + nodes.size() * sizeof(SNAPSHOT::Node);
+  header.namesOffset = header.colorsOffset + colors.size();
+  header.fileSize = header.namesOffset + names.size();
+
+  std::ofstream file(filename, std::ios::binary);
+  if (!file) {
+    std::cerr << "Error opening the snapshot file." << std::endl;
+    return false;
+  }
+  file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char *>(nodes.data()), nodes.size() * sizeof(SNAPSHOT::Node));
+  file.write(reinterpret_cast<const char *>(colors.data()), colors.size());
+  file.write(names.data(), names.size());
+  return static_cast<bool>(file);
+}
+
+/**
+ * @brief A read-only Red-Black Tree served directly from a memory-mapped snapshot file.
+ *
+ * Loading maps the file and validates it in one pass over the nodes, so a truncated or corrupt file is
+ * rejected instead of being read out of bounds; there is no parsing or allocation per node. Nodes are
+ * addressed by their inorder position, so successor and predecessor are O(1) position steps.
+ */
+class RedBlackTreeSnapshot {
+private:
+  void *mapping;                  // Start of the mapped file, or null if nothing is loaded
+  size_t mappingSize;             // Size of the mapping
+  const SNAPSHOT::Header *header; // Header at the start of the mapping
+  const SNAPSHOT::Node *nodes;    // Nodes section
+  const unsigned char *colors;    // Colors section
+  const char *names;              // Names section
+
+  /**
+   * @brief Helper function to unmap the loaded file, if any.
+   */
+  void unload() {
+    if (mapping != nullptr) {
+      munmap(mapping, mappingSize);
+    }
+    mapping = nullptr;
+    mappingSize = 0;
+    header = nullptr;
+  }
+
+  /**
+   * @brief Helper function to check that the nodes form a binary search tree whose inorder is the node order.
+   *
+   * Every child index and name offset is checked against the sections, so the queries never leave the
+   * mapping. The walk rejects the file as soon as a node is reached out of order, so a cycle cannot loop.
+   *
+   * @return True if the nodes section is consistent, otherwise false.
+   */
+  bool validateNodes() const {
+    uint32_t nodeCount = header->nodeCount;
+    uint64_t namesSize = header->fileSize - header->namesOffset;
+    if (nodeCount >= SNAPSHOT::NIL || (header->root == SNAPSHOT::NIL) != (nodeCount == 0) ||
+        (header->root != SNAPSHOT::NIL && header->root >= nodeCount)) {
+      return false;
+    }
+    for (uint32_t i = 0; i < nodeCount; i++) {
+      const SNAPSHOT::Node &node = nodes[i];
+      if ((node.left != SNAPSHOT::NIL && node.left >= nodeCount) || (node.right != SNAPSHOT::NIL && node.right >= nodeCount) ||
+          node.nameOffset > namesSize || (i > 0 && (node.nameOffset < nodes[i - 1].nameOffset || node.data < nodes[i - 1].data))) {
+        return false;
+      }
+    }
+
+    std::vector<uint32_t> path; // Ancestors whose left subtree is being visited
+    uint32_t current = header->root;
+    uint32_t expected = 0;      // Position the next visited node must have
+    while (current != SNAPSHOT::NIL || !path.empty()) {
+      if (current != SNAPSHOT::NIL) {
+        if (path.size() >= nodeCount) {
+          return false; // Deeper than the number of nodes, the children form a cycle
+        }
+        path.push_back(current);
+        current = nodes[current].left;
+      } else {
+        current = path.back();
+        path.pop_back();
+        if (current != expected++) {
+          return false;
+        }
+        current = nodes[current].right;
+      }
+    }
+    return expected == nodeCount;
+  }
+
+public:
+  /**
+   * @brief Constructor to initialize an empty snapshot, load fills it.
+   */
+  RedBlackTreeSnapshot() : mapping(nullptr), mappingSize(0), header(nullptr), nodes(nullptr), colors(nullptr), names(nullptr) {}
+
+  /**
+   * @brief Destructor to unmap the snapshot file.
+   */
+  ~RedBlackTreeSnapshot() {
+    unload();
+  }
+
+  RedBlackTreeSnapshot(const RedBlackTreeSnapshot &) = delete;
+  RedBlackTreeSnapshot &operator=(const RedBlackTreeSnapshot &) = delete;
+
+  /**
+   * @brief Maps a snapshot file written by writeSnapshot, replacing the previously loaded one.
+   * @param filename The name of the snapshot file.
+   * @return True if the file is mapped and valid, otherwise false.
+   */
+  bool load(const char *filename) {
+    unload();
+    int descriptor = open(filename, O_RDONLY);
+    if (descriptor < 0) {
+      std::cerr << "Error opening the snapshot file." << std::endl;
+      return false;
+    }
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || static_cast<size_t>(status.st_size) < sizeof(SNAPSHOT::Header)) {
+      std::cerr << "Invalid snapshot file." << std::endl;
+      close(descriptor);
+      return false;
+    }
+    mappingSize = status.st_size;
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor); // The mapping stays valid after the descriptor is closed
+    if (mapping == MAP_FAILED) {
+      mapping = nullptr;
+      std::cerr << "Error mapping the snapshot file." << std::endl;
+      return false;
+    }
+
+    header = static_cast<const SNAPSHOT::Header *>(mapping);
+    const char *base = static_cast<const char *>(mapping);
+    uint64_t nodesEnd = sizeof(SNAPSHOT::Header) + static_cast<uint64_t>(header->nodeCount) * sizeof(SNAPSHOT::Node);
+    if (std::memcmp(header->magic, "RBT1", 4) != 0 || header->fileSize != mappingSize || header->colorsOffset != nodesEnd ||
+        header->namesOffset != header->colorsOffset + (header->nodeCount + 7) / 8 || header->namesOffset > mappingSize) {
+      std::cerr << "Invalid snapshot file." << std::endl;
+      unload();
+      return false;
+    }
+    nodes = reinterpret_cast<const SNAPSHOT::Node *>(base + sizeof(SNAPSHOT::Header));
+    colors = reinterpret_cast<const unsigned char *>(base + header->colorsOffset);
+    names = base + header->namesOffset;
+    if (!validateNodes()) {
+      std::cerr << "Invalid snapshot file." << std::endl;
+      unload();
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief Function to search the tree iteratively for a given value.
+   * @param value The value to search for.
+   * @return The position of a node with the given value, or -1 if not found.
+   */
+  int searchTree(int value) const {
+    uint32_t current = header != nullptr ? header->root : SNAPSHOT::NIL;
+    while (current != SNAPSHOT::NIL && nodes[current].data != value) {
+      current = value < nodes[current].data ? nodes[current].left : nodes[current].right;
+    }
+    return current != SNAPSHOT::NIL ? static_cast<int>(current) : -1;
+  }
+
+  /**
+   * @brief Find the successor of the node at the given position.
+   * @param position The position of the node.
+   * @return The position of the successor, or -1 if there is none.
+   */
+  int successor(int position) const {
+    return position >= 0 && position + 1 < getTotalNodes() ? position + 1 : -1;
+  }
+
+  /**
+   * @brief Find the predecessor of the node at the given position.
+   * @param position The position of the node.
+   * @return The position of the predecessor, or -1 if there is none.
+   */
+  int predecessor(int position) const {
+    return position > 0 && position < getTotalNodes() ? position - 1 : -1;
+  }
+
+  /**
+   * @brief Gets the population of the node at the given position.
+   * @param position The position of the node.
+   * @return The population.
+   */
+  int getData(int position) const {
+    return nodes[position].data;
+  }
+
+  /**
+   * @brief Gets the city name of the node at the given position, pointing into the mapped file.
+   * @param position The position of the node.
+   * @return The city name, valid while the snapshot stays loaded.
+   */
+  std::string_view getName(int position) const {
+    uint32_t begin = nodes[position].nameOffset;
+    uint32_t end = position + 1 < getTotalNodes() ? nodes[position + 1].nameOffset : header->fileSize - header->namesOffset;
+    return std::string_view(names + begin, end - begin);
+  }
+
+  /**
+   * @brief Gets the color of the node at the given position.
+   * @param position The position of the node.
+   * @return RED or BLACK.
+   */
+  int getColor(int position) const {
+    return (colors[position / 8] >> (position % 8)) & 1 ? RED : BLACK;
+  }
+
+  /**
+   * @brief Gets the total number of nodes in the snapshot.
+   * @return The total number of nodes, or 0 if nothing is loaded.
+   */
+  int getTotalNodes() const {
+    return header != nullptr ? header->nodeCount : 0;
+  }
+
+}; // End of RedBlackTreeSnapshot class
@@ -0,0 +1,255 @@
+// Implementing Splay Tree in C++
+// tree_helpers.cpp must be included before this file
+
+/**
+  BLG335E - Analysis of Algorithms I - Project 3
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+#include <iostream>
+#include <algorithm>
+
+/**
+ * @brief Node struct to hold attributes of each node inside a namespace for the Splay Tree.
+ */
+namespace SPLAY {
+  struct Node {
+    int data;
+    std::string name;
+    Node *parent;
+    Node *left;
+    Node *right;
+  };
+}
+
+/**
+ * @brief A class representing a self-adjusting Splay Tree.
+ *
+ * Every inserted or searched node is rotated to the root, so frequently queried cities stay near the
+ * top. The operations take O(log n) amortized time, and a skewed query mix is served faster than by
+ * a tree of fixed shape.
+ */
+class SplayTree {
+private:
+  SPLAY::Node *root; // Pointer to the root node of the tree
+  int nodeCount;     // Number of nodes in the tree
+
+  /**
+   * @brief Moves the given node to the root with zig, zig-zig and zig-zag steps.
+   * @param x The node to be splayed.
+   */
+  void splay(SPLAY::Node *x) {
+    while (x->parent != nullptr) {
+      SPLAY::Node *p = x->parent;
+      SPLAY::Node *g = p->parent;
+      if (g == nullptr) { // Zig
+        if (x == p->left)
+          TREE::rightRotate(root, p);
+        else
+          TREE::leftRotate(root, p);
+      } else if (x == p->left && p == g->left) { // Zig-zig
+        TREE::rightRotate(root, g);
+        TREE::rightRotate(root, p);
+      } else if (x == p->right && p == g->right) { // Zig-zig
+        TREE::leftRotate(root, g);
+        TREE::leftRotate(root, p);
+      } else if (x == p->right) { // Zig-zag, p is a left child
+        TREE::leftRotate(root, p);
+        TREE::rightRotate(root, g);
+      } else { // Zig-zag, p is a right child
+        TREE::rightRotate(root, p);
+        TREE::leftRotate(root, g);
+      }
+    }
+  }
+
+public:
+  /**
+   * @brief Constructor to initialize the root node to null.
+   */
+  SplayTree() {
+    root = nullptr;
+    nodeCount = 0;
+  }
+
+  /**
+   * @brief Destructor to free the memory allocated for nodes in the Splay Tree.
+   */
+  ~SplayTree() {
+    TREE::destroyTree(root);
+  }
+
+  /**
+   * @brief Function to traverse the tree in inorder and store the data in the given array.
+   * @param orderedData The array to store the data in.
+   * @param startIndex The starting index of the array to store the data in, if given as 0 it simply starts the array in 0th index.
+   */
+  void inorder(std::pair<std::string, int> orderedData[], int startIndex) {
+    int index = startIndex;
+    TREE::inorderHelper(root, orderedData, index);
+  }
+
+  /**
+   * @brief Function to search the tree for a given value and splay the result.
+   *
+   * The found node is moved to the root. On a miss the last node visited is splayed instead, so a
+   * failed search also pays for itself.
+   *
+   * @param value The value to search for.
+   * @return The node with the given value, if found. Otherwise, returns null.
+   */
+  SPLAY::Node* searchTree(int value) {
+    SPLAY::Node* current = root;
+    SPLAY::Node* last = nullptr;
+    while (current != nullptr && current->data != value) {
+      last = current;
+      if (value < current->data) {
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    if (current != nullptr) {
+      splay(current);
+    } else if (last != nullptr) {
+      splay(last);
+    }
+    return current;
+  }
+
+  /**
+  * @brief Find the successor of a node in the Splay Tree (Splay).
+  * @param node The node for which to find the successor.
+  * @return A pointer to the successor node, or nullptr if there is none.
+  */
+  SPLAY::Node* successor(SPLAY::Node* node) {
+    return TREE::successor(node);
+  }
+
+  /**
+  * @brief Find the predecessor of a node in the Splay Tree (Splay).
+  * @param node The node for which to find the predecessor.
+  * @return A pointer to the predecessor node, or nullptr if there is none.
+  */
+  SPLAY::Node* predecessor(SPLAY::Node* node) {
+    return TREE::predecessor(node);
+  }
+
+  /**
+  * @brief Inserts a new node with the given name and population into the Splay Tree and splays it to the root.
+  * @param name The name of the city.
+  * @param data The population of the city.
+  * @return The inserted node, which can later be passed to deleteNode.
+  */
+  SPLAY::Node* insert(const std::string& name, int data) {
+    SPLAY::Node* z = new SPLAY::Node;
+    z->name = name;
+    z->data = data;
+    z->left = nullptr;
+    z->right = nullptr;
+
+    SPLAY::Node* y = nullptr;
+    SPLAY::Node* x = root;
+
+    // Traverse the tree to find the appropriate position for the new node, equal keys go right
+    while (x != nullptr) {
+      y = x;
+      x = data < x->data ? x->left : x->right;
+    }
+
+    z->parent = y;
+    if (y == nullptr)
+      root = z;
+    else if (data < y->data)
+      y->left = z;
+    else
+      y->right = z;
+    nodeCount++;
+
+    splay(z);
+    return z;
+  }
+
+  /**
+  * @brief Deletes the given node from the Splay Tree.
+  *
+  * The node is splayed to the root and removed, then the maximum of its left subtree is splayed to the
+  * top of that subtree, where it has no right child and the right subtree is attached.
+  *
+  * @param z The node to be deleted, e.g. the result of insert or searchTree. It is freed by this call.
+  */
+  void deleteNode(SPLAY::Node* z) {
+    if (z == nullptr) {
+      return; // Nothing to delete
+    }
+
+    splay(z);
+    SPLAY::Node* leftTree = z->left;
+    SPLAY::Node* rightTree = z->right;
+    if (leftTree == nullptr) {
+      root = rightTree;
+      if (rightTree != nullptr)
+        rightTree->parent = nullptr;
+    } else {
+      leftTree->parent = nullptr;
+      root = leftTree;
+      SPLAY::Node* maximum = TREE::findMax(leftTree);
+      splay(maximum);
+      maximum->right = rightTree;
+      if (rightTree != nullptr)
+        rightTree->parent = maximum;
+    }
+
+    delete z;
+    nodeCount--;
+  }
+
+  /**
+  * @brief Deletes a node with the given data from the Splay Tree (Splay).
+  * @param data The data value of the node to be deleted.
+  */
+  void deleteNode(int data) {
+    deleteNode(searchTree(data));
+  }
+
+  /**
+   * @brief Function to get the height of the tree.
+   * @return The height of the tree.
+   */
+  int getHeight() {
+    return TREE::getHeightHelper(root) - 1; // (Count of nodes from top  to bottom) - 1 = height
+  }
+
+  /**
+  * @brief Gets the node with the maximum value in the Splay Tree (Splay).
+  * @return The node with the maximum value, or nullptr if the tree is empty.
+  */
+  SPLAY::Node *getMaximum() {
+    if (root == nullptr) {
+      return nullptr; // Tree is empty
+    }
+    return TREE::findMax(root);
+  }
+
+  /**
+  * @brief Gets the node with the minimum value in the Splay Tree (Splay).
+  * @return The node with the minimum value, or nullptr if the tree is empty.
+  */
+  SPLAY::Node *getMinimum() {
+    if (root == nullptr) {
+      return nullptr; // Tree is empty
+    }
+    return TREE::findMin(root);
+  }
+
+  /**
+  * @brief Gets the total number of nodes in the Splay Tree (Splay).
+  * @return The total number of nodes, or 0 if the tree is empty.
+  */
+  int getTotalNodes() {
+    return nodeCount;
+  }
+
+}; // End of SplayTree class
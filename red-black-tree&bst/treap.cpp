@@ -0,0 +1,213 @@
+// Implementing Treap in C++
+// tree_helpers.cpp must be included before this file
+
+/**
+  BLG335E - Analysis of Algorithms I - Project 3
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+#include <iostream>
+#include <algorithm>
+#include <random>
+
+/**
+ * @brief Node struct to hold attributes of each node inside a namespace for the Treap.
+ */
+namespace TREAP {
+  struct Node {
+    int data;
+    std::string name;
+    unsigned int priority; // Random heap priority, a parent's priority is never lower than its children's
+    Node *parent;
+    Node *left;
+    Node *right;
+  };
+}
+
+/**
+ * @brief A class representing a Treap, a Binary Search Tree on populations and a max-heap on random priorities.
+ *
+ * The random priorities make the shape that of a randomly built Binary Search Tree whatever the
+ * insertion order, so the expected height is O(log n) without storing any balance information.
+ */
+class Treap {
+private:
+  TREAP::Node *root;         // Pointer to the root node of the tree
+  int nodeCount;             // Number of nodes in the tree
+  std::mt19937 generator;    // Source of the node priorities, seeded so runs are reproducible
+
+public:
+  /**
+   * @brief Constructor to initialize the root node to null.
+   */
+  Treap() {
+    root = nullptr;
+    nodeCount = 0;
+    generator.seed(335);
+  }
+
+  /**
+   * @brief Destructor to free the memory allocated for nodes in the Treap.
+   */
+  ~Treap() {
+    TREE::destroyTree(root);
+  }
+
+  /**
+   * @brief Function to traverse the tree in inorder and store the data in the given array.
+   * @param orderedData The array to store the data in.
+   * @param startIndex The starting index of the array to store the data in, if given as 0 it simply starts the array in 0th index.
+   */
+  void inorder(std::pair<std::string, int> orderedData[], int startIndex) {
+    int index = startIndex;
+    TREE::inorderHelper(root, orderedData, index);
+  }
+
+  /**
+   * @brief Function to search the tree iteratively for a given value.
+   * @param value The value to search for.
+   * @return The node with the given value, if found. Otherwise, returns null.
+   */
+  TREAP::Node* searchTree(int value) {
+    return TREE::searchTree(root, value);
+  }
+
+  /**
+  * @brief Find the successor of a node in the Treap (Treap).
+  * @param node The node for which to find the successor.
+  * @return A pointer to the successor node, or nullptr if there is none.
+  */
+  TREAP::Node* successor(TREAP::Node* node) {
+    return TREE::successor(node);
+  }
+
+  /**
+  * @brief Find the predecessor of a node in the Treap (Treap).
+  * @param node The node for which to find the predecessor.
+  * @return A pointer to the predecessor node, or nullptr if there is none.
+  */
+  TREAP::Node* predecessor(TREAP::Node* node) {
+    return TREE::predecessor(node);
+  }
+
+  /**
+  * @brief Inserts a new node with the given name and population into the Treap.
+  *
+  * The node is placed as a leaf as in a Binary Search Tree and then rotated up while its priority
+  * is higher than its parent's.
+  *
+  * @param name The name of the city.
+  * @param data The population of the city.
+  * @return The inserted node, which can later be passed to deleteNode.
+  */
+  TREAP::Node* insert(const std::string& name, int data) {
+    TREAP::Node* z = new TREAP::Node;
+    z->name = name;
+    z->data = data;
+    z->left = nullptr;
+    z->right = nullptr;
+    z->priority = generator();
+
+    TREAP::Node* y = nullptr;
+    TREAP::Node* x = root;
+
+    // Traverse the tree to find the appropriate position for the new node, equal keys go right
+    while (x != nullptr) {
+      y = x;
+      x = data < x->data ? x->left : x->right;
+    }
+
+    z->parent = y;
+    if (y == nullptr)
+      root = z;
+    else if (data < y->data)
+      y->left = z;
+    else
+      y->right = z;
+    nodeCount++;
+
+    while (z->parent != nullptr && z->parent->priority < z->priority) {
+      if (z == z->parent->left) {
+        TREE::rightRotate(root, z->parent);
+      } else {
+        TREE::leftRotate(root, z->parent);
+      }
+    }
+    return z;
+  }
+
+  /**
+  * @brief Deletes the given node from the Treap.
+  *
+  * The node is rotated down, always lifting the child with the higher priority, until it has at most
+  * one child, and is then spliced out.
+  *
+  * @param z The node to be deleted, e.g. the result of insert or searchTree. It is freed by this call.
+  */
+  void deleteNode(TREAP::Node* z) {
+    if (z == nullptr) {
+      return; // Nothing to delete
+    }
+
+    while (z->left != nullptr && z->right != nullptr) {
+      if (z->left->priority > z->right->priority) {
+        TREE::rightRotate(root, z);
+      } else {
+        TREE::leftRotate(root, z);
+      }
+    }
+    TREE::transplant(root, z, z->left != nullptr ? z->left : z->right);
+
+    delete z;
+    nodeCount--;
+  }
+
+  /**
+  * @brief Deletes a node with the given data from the Treap (Treap).
+  * @param data The data value of the node to be deleted.
+  */
+  void deleteNode(int data) {
+    deleteNode(searchTree(data));
+  }
+
+  /**
+   * @brief Function to get the height of the tree.
+   * @return The height of the tree.
+   */
+  int getHeight() {
+    return TREE::getHeightHelper(root) - 1; // (Count of nodes from top  to bottom) - 1 = height
+  }
+
+  /**
+  * @brief Gets the node with the maximum value in the Treap (Treap).
+  * @return The node with the maximum value, or nullptr if the tree is empty.
+  */
+  TREAP::Node *getMaximum() {
+    if (root == nullptr) {
+      return nullptr; // Tree is empty
+    }
+    return TREE::findMax(root);
+  }
+
+  /**
+  * @brief Gets the node with the minimum value in the Treap (Treap).
+  * @return The node with the minimum value, or nullptr if the tree is empty.
+  */
+  TREAP::Node *getMinimum() {
+    if (root == nullptr) {
+      return nullptr; // Tree is empty
+    }
+    return TREE::findMin(root);
+  }
+
+  /**
+  * @brief Gets the total number of nodes in the Treap (Treap).
+  * @return The total number of nodes, or 0 if the tree is empty.
+  */
+  int getTotalNodes() {
+    return nodeCount;
+  }
+
+}; // End of Treap class
@@ -0,0 +1,269 @@
+// Implementing the walks shared by the AVL Tree, Treap and Splay Tree in C++
+
+/**
+  BLG335E - Analysis of Algorithms I - Project 3
+  Author: Yusuf Yıldız
+  Student ID: 150210006
+  Date: 18.10.2026
+*/
+
+#include <iostream>
+#include <algorithm>
+
+/**
+ * @brief Helper functions shared by the binary search trees whose nodes have parent, left and right pointers.
+ *
+ * Every function is a template over the node type, so AVL::Node, TREAP::Node and SPLAY::Node use the same
+ * code. The functions that change the shape take the root of the tree by reference, since it may change.
+ */
+namespace TREE {
+  /**
+   * @brief Finds the minimum value in the tree rooted with given node.
+   * @param node The initial root of the subtree.
+   * @return The node with the minimum value in the tree rooted with given node.
+   */
+  template <class Node> Node *findMin(Node *node) {
+    while (node->left != nullptr) {
+      node = node->left;
+    }
+    return node;
+  }
+
+  /**
+   * @brief Finds the maximum value in the tree rooted with given node.
+   * @param node The initial root of the subtree.
+   * @return The node with the maximum value in the tree rooted with given node.
+   */
+  template <class Node> Node *findMax(Node *node) {
+    while (node->right != nullptr) {
+      node = node->right;
+    }
+    return node;
+  }
+
+  /**
+   * @brief Finds the first node of the subtree in postorder, the leaf reached by preferring left children.
+   * @param node The root of the subtree.
+   * @return The first leaf of the subtree.
+   */
+  template <class Node> Node *findFirstLeaf(Node *node) {
+    while (node->left != nullptr || node->right != nullptr) {
+      node = node->left != nullptr ? node->left : node->right;
+    }
+    return node;
+  }
+
+  /**
+   * @brief Iteratively deletes nodes starting from the given node.
+   * @param node The root of the subtree being deleted.
+   */
+  template <class Node> void destroyTree(Node *node) {
+    if (node == nullptr) {
+      return;
+    }
+    Node *stop = node->parent; // Parent of the subtree, the walk ends when it is reached
+    Node *current = findFirstLeaf(node);
+    while (current != nullptr) {
+      Node *parent = current->parent;
+      Node *next;
+      if (parent == stop) {
+        next = nullptr;                         // The subtree root is deleted last
+      } else if (current == parent->left && parent->right != nullptr) {
+        next = findFirstLeaf(parent->right);    // Delete the right subtree before the parent
+      } else {
+        next = parent;
+      }
+      delete current; // Delete the current node, its children are already deleted
+      current = next;
+    }
+  }
+
+  /**
+   * @brief Traverses the tree in inorder iteratively and stores the data in the given array.
+   * @param node The root of the subtree being traversed.
+   * @param orderedData The array to store the data in.
+   * @param index The index of the array to store the data in.
+   */
+  template <class Node> void inorderHelper(Node *node, std::pair<std::string, int> orderedData[], int &index) {
+    if (node == nullptr) {
+      return;
+    }
+    Node *stop = node->parent;
+    Node *current = findMin(node);
+    while (current != nullptr) {
+      orderedData[index++] = std::make_pair(current->name, current->data);
+      if (current->right != nullptr) {
+        current = findMin(current->right);
+      } else { // Climb until coming up from a left child
+        while (current->parent != stop && current == current->parent->right) {
+          current = current->parent;
+        }
+        current = current->parent != stop ? current->parent : nullptr;
+      }
+    }
+  }
+
+  /**
+   * @brief Gets the height of the tree iteratively by following parent pointers.
+   * @param node The root of the subtree being traversed.
+   * @return The total count of nodes in tree. To get the height, subtract 1 from the result.
+   */
+  template <class Node> int getHeightHelper(Node *node) {
+    if (node == nullptr) { // Base case: empty tree
+      return 0;
+    }
+    Node *stop = node->parent;
+    Node *previous = stop;
+    Node *current = node;
+    int depth = 0;
+    int height = 0;
+    while (current != stop) {
+      Node *next;
+      if (previous == current->parent) { // Entered from the parent
+        depth++;
+        height = std::max(height, depth);
+        next = current->left != nullptr ? current->left : (current->right != nullptr ? current->right : current->parent);
+      } else if (previous == current->left) { // Came back from the left child
+        next = current->right != nullptr ? current->right : current->parent;
+      } else { // Came back from the right child
+        next = current->parent;
+      }
+      if (next == current->parent) {
+        depth--;
+      }
+      previous = current;
+      current = next;
+    }
+    return height;
+  }
+
+  /**
+   * @brief Searches the tree iteratively for a given value.
+   * @param root The root of the tree.
+   * @param value The value to search for.
+   * @return The node with the given value, if found. Otherwise, returns null.
+   */
+  template <class Node> Node *searchTree(Node *root, int value) {
+    Node *current = root;
+    while (current != nullptr && current->data != value) {
+      if (value < current->data) {
+        current = current->left;
+      } else {
+        current = current->right;
+      }
+    }
+    return current;
+  }
+
+  /**
+   * @brief Finds the successor of a node.
+   * @param node The node for which to find the successor.
+   * @return A pointer to the successor node, or nullptr if there is none.
+   */
+  template <class Node> Node *successor(Node *node) {
+    if (node == nullptr) {
+      return nullptr;
+    }
+    if (node->right != nullptr) {
+      return findMin(node->right);
+    }
+    Node *ancestor = node->parent;
+    while (ancestor != nullptr && node == ancestor->right) {
+      node = ancestor;
+      ancestor = ancestor->parent;
+    }
+    return ancestor;
+  }
+
+  /**
+   * @brief Finds the predecessor of a node.
+   * @param node The node for which to find the predecessor.
+   * @return A pointer to the predecessor node, or nullptr if there is none.
+   */
+  template <class Node> Node *predecessor(Node *node) {
+    if (node == nullptr) {
+      return nullptr;
+    }
+    if (node->left != nullptr) {
+      return findMax(node->left);
+    }
+    Node *ancestor = node->parent;
+    while (ancestor != nullptr && node == ancestor->left) {
+      node = ancestor;
+      ancestor = ancestor->parent;
+    }
+    return ancestor;
+  }
+
+  /**
+   * @brief Replaces the subtree rooted at node u with the subtree rooted at node v.
+   * @param root The root of the tree, updated if u is the root.
+   * @param u The node to be replaced.
+   * @param v The node to replace the node u.
+   */
+  template <class Node> void transplant(Node *&root, Node *u, Node *v) {
+    if (u->parent == nullptr) {
+      root = v;
+    } else if (u == u->parent->left) {
+      u->parent->left = v;
+    } else {
+      u->parent->right = v;
+    }
+
+    if (v != nullptr) {
+      v->parent = u->parent;
+    }
+  }
+
+  /**
+   * @brief Performs a left rotation around the given node.
+   * @param root The root of the tree, updated if x is the root.
+   * @param x The node around which the left rotation is performed.
+   * @return The node that takes the place of x.
+   */
+  template <class Node> Node *leftRotate(Node *&root, Node *x) {
+    Node *y = x->right;
+    x->right = y->left;
+    if (y->left != nullptr)
+      y->left->parent = x;
+
+    y->parent = x->parent;
+
+    if (x->parent == nullptr)
+      root = y;
+    else if (x == x->parent->left)
+      x->parent->left = y;
+    else
+      x->parent->right = y;
+
+    y->left = x;
+    x->parent = y;
+    return y;
+  }
+
+  /**
+   * @brief Performs a right rotation around the given node.
+   * @param root The root of the tree, updated if y is the root.
+   * @param y The node around which the right rotation is performed.
+   * @return The node that takes the place of y.
+   */
+  template <class Node> Node *rightRotate(Node *&root, Node *y) {
+    Node *x = y->left;
+    y->left = x->right;
+    if (x->right != nullptr)
+      x->right->parent = y;
+
+    x->parent = y->parent;
+
+    if (y->parent == nullptr)
+      root = x;
+    else if (y == y->parent->left)
+      y->parent->left = x;
+    else
+      y->parent->right = x;
+
+    x->right = y;
+    y->parent = x;
+    return x;
+  }
+}